@@ -0,0 +1,552 @@
+/**
+ * Benchmark harness for the bank's data paths and operations, driving
+ * FileHandler and BankSystem directly on seeded synthetic data (see
+ * SyntheticData.h). Every operation is timed one call at a time and reported
+ * as p50/p99/mean/max latency plus throughput, as JSON, so runs of different
+ * releases can be compared mechanically.
+ *
+ * Usage: bank_bench [--accounts N] [--transactions N] [--ops N] [--durable-ops N]
+ *                   [--password-cost N] [--load-threads a,b,...] [--login-costs a,b,...]
+ *                   [--logins N] [--storm-logins N] [--seed N] [--as-of epoch] [--dir path] [--out file.json]
+ *                   [--keep-data | --generate-only]
+ *
+ *   --accounts      generated accounts (default 100000, up to 10M)
+ *   --transactions  generated transactions (default 10 per account)
+ *   --ops           calls per in-memory operation (default 100000)
+ *   --durable-ops   calls per operation that syncs the journal (default 2000)
+ *   --password-cost password hash cost of the main bank (default 1, so hashing
+ *                   the generated plaintext passwords at start-up stays quick)
+ *   --load-threads  parser thread counts of the transaction load sweep
+ *                   (default 1,2,4,8,16; 1 is the single-threaded baseline)
+ *   --login-costs   costs of the concurrent login runs (default 8,10,12,14)
+ *   --logins        logins per cost (default 64)
+ *   --storm-logins  failed logins per brute-force storm run (default 2000000)
+ *   --seed          generator seed (default 42)
+ *   --as-of         generation time in Unix seconds (default now); fix it with
+ *                   --seed to reproduce the data files byte for byte
+ *   --dir           scratch directory for the data files (default bench_data)
+ *   --out           JSON output file (default: standard output)
+ *   --keep-data     leave the data files in --dir (as the benchmark left them)
+ *   --generate-only write accounts.csv and transactions.csv to --dir and stop
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../include/Bank System/BankSystem.h"
+#include "../include/utils/Algorithms.h"
+#include "SyntheticData.h"
+#include "BenchStats.h"
+
+namespace {
+
+uint64_t fileSize(const std::string& path) {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+}
+
+// Resident set size of this process (0 where /proc isn't available)
+int64_t residentKilobytes() {
+    std::ifstream statm("/proc/self/statm");
+    long long totalPages = 0;
+    long long residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * ::sysconf(_SC_PAGESIZE) / 1024;
+}
+
+struct Options {
+    SyntheticDataConfig data;
+    size_t ops;
+    size_t durableOps;
+    unsigned passwordCost;
+    std::vector<unsigned> loadThreads;
+    std::vector<unsigned> loginCosts;
+    size_t logins;
+    size_t stormLogins;
+    std::string dir;
+    std::string out;
+    bool keepData;
+    bool generateOnly;
+
+    Options() : ops(100000), durableOps(2000), passwordCost(PasswordHash::MIN_COST), logins(64),
+                stormLogins(2000000), dir("bench_data"), keepData(false), generateOnly(false) {
+        data.transactions = 0;   // 0 = 10 per account
+        for (unsigned threads = 1; threads <= 16; threads *= 2) {
+            loadThreads.push_back(threads);
+        }
+        for (unsigned cost = 8; cost <= 14; cost += 2) {
+            loginCosts.push_back(cost);
+        }
+    }
+};
+
+// Times fn() count times, one sample per call
+template<typename Fn>
+std::vector<double> sample(size_t count, Fn fn) {
+    std::vector<double> nanos;
+    nanos.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        BenchClock::time_point start = BenchClock::now();
+        fn(i);
+        nanos.push_back(nanosSince(start));
+    }
+    return nanos;
+}
+
+// Cheapest observed cost of one timing, to judge the sub-microsecond results
+double timerOverhead() {
+    double best = 1e18;
+    for (int i = 0; i < 1000; ++i) {
+        BenchClock::time_point start = BenchClock::now();
+        best = std::min(best, nanosSince(start));
+    }
+    return best;
+}
+
+// BankSystem reports to the interactive user on std::cout; mute it while timing
+class QuietOutput {
+    std::streambuf* saved;
+
+public:
+    QuietOutput() : saved(std::cout.rdbuf(nullptr)) {}
+    ~QuietOutput() {
+        std::cout.rdbuf(saved);
+        std::cout.clear();
+    }
+};
+
+/**
+ * Rows per second of one transaction load with a fixed number of parser
+ * threads, as FileHandler measured it (the time of the parse and merge, not
+ * of mapping the file)
+ */
+BenchResult benchLoadThreads(const std::string& accFile, const std::string& transFile, unsigned threads) {
+    FileHandler files(accFile, transFile);
+    files.setLoadThreads(threads);
+    std::vector<Transaction> transactions;
+    std::vector<double> nanos;
+    {
+        QuietOutput quiet;
+        nanos = sample(1, [&](size_t) { files.loadTransactions(transactions); });
+    }
+    FileHandler::LoadStats stats = files.getLastLoadStats();
+    BenchResult result = summarize("FileHandler.loadTransactions.threads" + std::to_string(threads), nanos,
+                                   transactions.size());
+    if (stats.threads == threads) result.throughput = stats.rowsPerSecond();
+    return result;
+}
+
+/**
+ * Logins per second at one password cost: a small bank hashed at that cost,
+ * logged into by twice as many concurrent sessions as there are hardware
+ * threads, so the verification pool never waits for work. Every login is one
+ * sample; the throughput is logins over the wall-clock time of the run.
+ */
+BenchResult benchLogins(const Options& options, unsigned cost) {
+    const std::string password = "Bench#Pass1";
+    std::string prefix = options.dir + "/logins.";
+    size_t sessions = std::max<size_t>(4, 2 * std::thread::hardware_concurrency());
+
+    QuietOutput quiet;
+    BankSystem* bank = new BankSystem(prefix + "accounts.csv", prefix + "transactions.csv", prefix + "bank.journal",
+                                      prefix + "bank.snapshot", 16, AccountIdAllocator::DEFAULT_LAST, cost);
+    std::vector<BatchOperation> creates(sessions);
+    for (BatchOperation& op : creates) {
+        op.type = BatchOperation::CREATE;
+        op.customerName = "Login Bench";
+        op.accountType = "Checking";
+        op.password = password;
+    }
+    std::vector<BatchResult> created;
+    bank->applyBatch(creates, created);
+
+    std::vector<std::vector<double> > sessionNanos(sessions);
+    std::vector<std::thread> threads;
+    BenchClock::time_point start = BenchClock::now();
+    for (size_t s = 0; s < sessions; ++s) {
+        threads.push_back(std::thread([&, s] {
+            for (size_t i = s; i < options.logins; i += sessions) {
+                BenchClock::time_point call = BenchClock::now();
+                bank->validateAccount(created[s].accountId, password);
+                sessionNanos[s].push_back(nanosSince(call));
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double wallNanos = nanosSince(start);
+    delete bank;
+    const char* const files[] = {"accounts.csv", "accounts.csv.delta", "transactions.csv", "bank.journal",
+                                 "bank.snapshot", "bank.snapshot.ledger"};
+    for (const char* file : files) {
+        ::unlink((prefix + file).c_str());
+    }
+
+    std::vector<double> nanos;
+    for (const std::vector<double>& calls : sessionNanos) {
+        nanos.insert(nanos.end(), calls.begin(), calls.end());
+    }
+    BenchResult result = summarize("BankSystem.validateAccount.cost" + std::to_string(cost), nanos);
+    result.throughput = nanos.empty() ? 0.0 : nanos.size() * 1e9 / wallNanos;
+    return result;
+}
+
+/**
+ * Brute-force storms, with the resident set size before and after each:
+ * - failed attempts round-robin over a thousand accounts, booked straight
+ *   on the accounts (their lockout state has a fixed size, so memory stays
+ *   flat however many failures arrive)
+ * - wrong passwords against a small bank at the default login throttle,
+ *   which turns away nearly all of them before any account is looked up
+ * The samples go to a buffer filled in before the first reading.
+ */
+void benchLoginStorms(const Options& options, std::vector<BenchResult>& stormResults) {
+    const size_t stormAccounts = 1000;
+    std::vector<double> buffer(options.stormLogins);
+    std::vector<double> nanos;
+    auto storm = [&](const std::function<void(size_t)>& attempt) {
+        int64_t before = residentKilobytes();
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            BenchClock::time_point start = BenchClock::now();
+            attempt(i);
+            buffer[i] = nanosSince(start);
+        }
+        int64_t after = residentKilobytes();
+        nanos = buffer;
+        return after - before;
+    };
+    QuietOutput quiet;
+
+    std::vector<CheckingAccount> targets;
+    targets.reserve(stormAccounts);
+    for (size_t i = 0; i < stormAccounts; ++i) {
+        targets.push_back(CheckingAccount(syntheticAccountId(i), "Storm Target", Money(), "Storm#Pass1"));
+    }
+    int64_t growth = storm([&](size_t i) { targets[i % stormAccounts].finishLogin(false); });
+    stormResults.push_back(summarize("Account.finishLogin.failureStorm", nanos));
+    stormResults.back().memoryMeasured = true;
+    stormResults.back().rssGrowthKb = growth;
+
+    std::string prefix = options.dir + "/storm.";
+    BankSystem* bank = new BankSystem(prefix + "accounts.csv", prefix + "transactions.csv", prefix + "bank.journal",
+                                      prefix + "bank.snapshot", 16, AccountIdAllocator::DEFAULT_LAST,
+                                      PasswordHash::MIN_COST);
+    std::vector<BatchOperation> creates(stormAccounts);
+    for (BatchOperation& op : creates) {
+        op.type = BatchOperation::CREATE;
+        op.customerName = "Storm Target";
+        op.accountType = "Checking";
+        op.password = "Storm#Pass1";
+    }
+    std::vector<BatchResult> created;
+    bank->applyBatch(creates, created);
+
+    growth = storm([&](size_t i) { bank->validateAccount(created[i % stormAccounts].accountId, "Wrong#Pass1"); });
+    stormResults.push_back(summarize("BankSystem.validateAccount.throttledStorm", nanos));
+    stormResults.back().memoryMeasured = true;
+    stormResults.back().rssGrowthKb = growth;
+    std::cerr << "Login throttle turned away " << bank->getThrottledLogins() << " of " << options.stormLogins
+              << " attempts" << std::endl;
+
+    delete bank;
+    const char* const files[] = {"accounts.csv", "accounts.csv.delta", "transactions.csv", "bank.journal",
+                                 "bank.snapshot", "bank.snapshot.ledger"};
+    for (const char* file : files) {
+        ::unlink((prefix + file).c_str());
+    }
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--keep-data") {
+            options.keepData = true;
+        } else if (arg == "--generate-only") {
+            options.generateOnly = true;
+        } else if (arg == "--accounts" && hasValue) {
+            options.data.accounts = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--transactions" && hasValue) {
+            options.data.transactions = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--ops" && hasValue) {
+            options.ops = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--durable-ops" && hasValue) {
+            options.durableOps = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--password-cost" && hasValue) {
+            options.passwordCost = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--load-threads" && hasValue) {
+            options.loadThreads.clear();
+            for (const std::string& threads : splitString(argv[++i], ',')) {
+                unsigned count = static_cast<unsigned>(std::strtoul(threads.c_str(), nullptr, 10));
+                if (count == 0) return false;
+                options.loadThreads.push_back(count);
+            }
+        } else if (arg == "--login-costs" && hasValue) {
+            options.loginCosts.clear();
+            for (const std::string& cost : splitString(argv[++i], ',')) {
+                options.loginCosts.push_back(static_cast<unsigned>(std::strtoul(cost.c_str(), nullptr, 10)));
+            }
+        } else if (arg == "--logins" && hasValue) {
+            options.logins = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--storm-logins" && hasValue) {
+            options.stormLogins = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            options.data.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--as-of" && hasValue) {
+            options.data.asOf = static_cast<std::time_t>(std::strtoll(argv[++i], nullptr, 10));
+        } else if (arg == "--dir" && hasValue) {
+            options.dir = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if (options.data.accounts == 0) return false;
+    if (options.data.transactions == 0) options.data.transactions = options.data.accounts * 10;
+    return true;
+}
+
+void writeJson(std::ostream& out, const Options& options, double overhead, const std::vector<BenchResult>& results) {
+    out << std::fixed << std::setprecision(1);
+    out << "{\n  \"schema\": 1,\n  \"config\": {\n"
+        << "    \"accounts\": " << options.data.accounts << ",\n"
+        << "    \"transactions\": " << options.data.transactions << ",\n"
+        << "    \"ops\": " << options.ops << ",\n"
+        << "    \"durable_ops\": " << options.durableOps << ",\n"
+        << "    \"password_cost\": " << options.passwordCost << ",\n"
+        << "    \"logins\": " << options.logins << ",\n"
+        << "    \"storm_logins\": " << options.stormLogins << ",\n"
+        << "    \"seed\": " << options.data.seed << ",\n"
+        << "    \"as_of\": " << static_cast<long long>(options.data.asOf) << ",\n"
+        << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "    \"compiler\": \"" << __VERSION__ << "\",\n"
+        << "    \"timer_overhead_ns\": " << overhead << "\n  },\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        out << "    ";
+        writeResultJson(out, results[i]);
+        out << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--accounts N] [--transactions N] [--ops N] [--durable-ops N]"
+                  << " [--password-cost N] [--load-threads a,b,...] [--login-costs a,b,...]"
+                  << " [--logins N] [--storm-logins N] [--seed N] [--as-of epoch] [--dir path] [--out file.json]"
+                  << " [--keep-data | --generate-only]" << std::endl;
+        return 1;
+    }
+
+    ::mkdir(options.dir.c_str(), 0755);
+    std::string accFile = options.dir + "/accounts.csv";
+    std::string transFile = options.dir + "/transactions.csv";
+    std::string journalFile = options.dir + "/bank.journal";
+    std::string snapFile = options.dir + "/bank.snapshot";
+    std::string copyFile = options.dir + "/accounts.copy.csv";
+    std::string copyTransFile = options.dir + "/transactions.copy.csv";
+    std::vector<BenchResult> results;
+    auto record = [&](const BenchResult& result) {
+        printSummary(result);
+        results.push_back(result);
+    };
+
+    double overhead = timerOverhead();
+    size_t accounts = options.data.accounts;
+    size_t rows = accounts + options.data.transactions;
+
+    // 1. Synthetic data
+    std::vector<double> nanos = sample(1, [&](size_t) {
+        if (!generateSyntheticData(options.data, accFile, transFile)) std::exit(1);
+    });
+    record(summarize("SyntheticData.generate", nanos, rows));
+    if (options.generateOnly) return 0;
+
+    // Accounts the in-memory operations use. The generated files hold plaintext passwords,
+    // which the bank replaces with hashes, so the logins take theirs from the parsed rows
+    std::mt19937_64 random(options.data.seed + 1);
+    std::vector<size_t> picks(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        picks[i] = random() % accounts;
+    }
+    std::vector<std::string> passwords(options.ops);
+
+    // 2. CSV parsing and writing through FileHandler alone
+    {
+        AccountPool pool;
+        std::vector<Account*> loaded;
+        std::vector<Transaction> transactions;
+        FileHandler files(accFile, transFile);
+        nanos = sample(1, [&](size_t) { files.loadAccounts(loaded, pool); });
+        record(summarize("FileHandler.loadAccounts", nanos, accounts));
+        nanos = sample(1, [&](size_t) { files.loadTransactions(transactions); });
+        record(summarize("FileHandler.loadTransactions", nanos, options.data.transactions));
+        for (size_t i = 0; i < options.ops; ++i) {
+            passwords[i] = loaded[picks[i]]->getPassword();
+        }
+
+        // Writers report MB/s of CSV text (1 MB = 10^6 bytes)
+        FileHandler copy(copyFile, copyTransFile);
+        nanos = sample(1, [&](size_t) { copy.saveAccounts(loaded); });
+        record(summarize("FileHandler.saveAccounts", nanos, accounts, fileSize(copyFile)));
+        nanos = sample(1, [&](size_t) { copy.saveTransactions(transactions); });
+        record(summarize("FileHandler.saveTransactions", nanos, options.data.transactions, fileSize(copyTransFile)));
+        uint64_t transactionBytes = fileSize(copyTransFile);
+        ::unlink(copyTransFile.c_str());
+        nanos = sample(1, [&](size_t) { copy.appendTransactions(transactions, 0); });
+        record(summarize("FileHandler.appendTransactions", nanos, options.data.transactions, transactionBytes));
+        ::unlink(copyFile.c_str());
+        ::unlink(copyTransFile.c_str());
+    }
+
+    // Transaction loads with each thread count of the sweep
+    for (unsigned threads : options.loadThreads) {
+        record(benchLoadThreads(accFile, transFile, threads));
+    }
+
+    // 3. BankSystem start-up. The first one hashes the generated plaintext passwords (and saves
+    //    everything); the second starts from the CSV files alone (no snapshot or ledger file, empty
+    //    journal) and writes the ledger file from them
+    ::unlink(journalFile.c_str());
+    ::unlink(snapFile.c_str());
+    ::unlink((snapFile + ".ledger").c_str());
+    uint64_t lastId = static_cast<uint64_t>(SYNTHETIC_FIRST_ACCOUNT) + accounts + options.durableOps + 1000;
+    uint32_t maxAccountNumber = static_cast<uint32_t>(std::min<uint64_t>(lastId, AccountId::MAX_VALUE));
+    BankSystem* bank = nullptr;
+    {
+        QuietOutput quiet;
+        nanos = sample(1, [&](size_t) {
+            bank = new BankSystem(accFile, transFile, journalFile, snapFile, 16, maxAccountNumber,
+                                  options.passwordCost);
+        });
+    }
+    record(summarize("BankSystem.migratePasswords", nanos, accounts));
+    delete bank;
+    ::unlink(journalFile.c_str());
+    ::unlink(snapFile.c_str());
+    ::unlink((snapFile + ".ledger").c_str());
+    ::unlink((accFile + ".delta").c_str());
+    nanos = sample(1, [&](size_t) {
+        bank = new BankSystem(accFile, transFile, journalFile, snapFile, 16, maxAccountNumber, options.passwordCost);
+    });
+    record(summarize("BankSystem.loadData.csv", nanos, rows));
+
+    // 4. Interest: every savings account catches up on accrualDays, then the no-op pass a save adds
+    nanos = sample(1, [&](size_t) { bank->applyInterestToAllSavingsAccounts(); });
+    record(summarize("BankSystem.applyInterestToAllSavingsAccounts.catchUp", nanos, accounts));
+    nanos = sample(5, [&](size_t) { bank->applyInterestToAllSavingsAccounts(); });
+    record(summarize("BankSystem.applyInterestToAllSavingsAccounts.upToDate", nanos, accounts));
+
+    // 5. In-memory operations on random existing accounts (logins at --password-cost)
+    std::vector<std::string> ids(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        ids[i] = syntheticAccountId(picks[i]);
+    }
+
+    nanos = sample(options.ops, [&](size_t i) { bank->findAccount(ids[i]); });
+    record(summarize("BankSystem.findAccount", nanos));
+    nanos = sample(options.ops, [&](size_t i) { bank->validateAccount(ids[i], passwords[i]); });
+    record(summarize("BankSystem.validateAccount", nanos));
+    volatile int strength = 0;
+    nanos = sample(options.ops, [&](size_t i) { strength = strength + checkPasswordStrength(passwords[i]); });
+    record(summarize("checkPasswordStrength", nanos));
+
+    // 6. Operations that wait for their journal record to be durable (one fsync each)
+    size_t durable = std::min(options.durableOps, options.ops);
+    nanos = sample(durable, [&](size_t i) { bank->deposit(ids[i], Money::fromCents(2500)); });
+    record(summarize("BankSystem.deposit", nanos));
+    nanos = sample(durable, [&](size_t i) { bank->withdraw(ids[i], Money::fromCents(1000)); });
+    record(summarize("BankSystem.withdraw", nanos));
+
+    // Background checkpoints, and the same deposits while another thread checkpoints back to back
+    nanos = sample(3, [&](size_t) { bank->checkpoint(); });
+    record(summarize("BankSystem.checkpoint", nanos, accounts));
+    {
+        // The bank's own persister, asked to checkpoint after every change
+        bank->startPersister(std::chrono::seconds(0), 1);
+        nanos = sample(durable, [&](size_t i) { bank->deposit(ids[i], Money::fromCents(2500)); });
+        bank->stopPersister();
+    }
+    record(summarize("BankSystem.deposit.duringCheckpoint", nanos));
+    {
+        QuietOutput quiet;
+        nanos = sample(options.durableOps, [&](size_t i) {
+            bank->createAccount("Bench " + std::to_string(static_cast<unsigned long long>(i)),
+                                (i % 2 == 0) ? "Savings" : "Checking", Money::fromCents(10000), "Bench#Pass1");
+        });
+    }
+    record(summarize("BankSystem.createAccount", nanos));
+
+    // 7. Persistence: full save (CSV + snapshot), incremental saves after a few changes each,
+    //    then start-up from the snapshot and the change segment
+    nanos = sample(1, [&](size_t) { bank->saveData(); });
+    record(summarize("BankSystem.saveData", nanos, accounts));
+    const size_t changesPerSave = 100;
+    nanos.clear();
+    for (size_t s = 0; s < 5; ++s) {
+        for (size_t i = 0; i < changesPerSave; ++i) {
+            bank->deposit(ids[(s * changesPerSave + i) % ids.size()], Money::fromCents(100));
+        }
+        BenchClock::time_point start = BenchClock::now();
+        bank->saveData();
+        nanos.push_back(nanosSince(start));
+    }
+    record(summarize("BankSystem.saveData.incremental", nanos, changesPerSave));
+    delete bank;
+
+    nanos = sample(1, [&](size_t) {
+        bank = new BankSystem(accFile, transFile, journalFile, snapFile, 16, maxAccountNumber, options.passwordCost);
+    });
+    record(summarize("BankSystem.loadData.snapshot", nanos, rows));
+    delete bank;
+
+    // 8. Login throughput against the password cost
+    for (unsigned cost : options.loginCosts) {
+        record(benchLogins(options, cost));
+    }
+
+    // 9. Brute-force storms: lockout state and the login throttle under millions of failures
+    std::vector<BenchResult> stormResults;
+    benchLoginStorms(options, stormResults);
+    for (const BenchResult& result : stormResults) {
+        record(result);
+    }
+
+    if (!options.keepData) {
+        ::unlink(accFile.c_str());
+        ::unlink((accFile + ".delta").c_str());
+        ::unlink(transFile.c_str());
+        ::unlink(journalFile.c_str());
+        ::unlink(snapFile.c_str());
+        ::unlink((snapFile + ".ledger").c_str());
+        ::rmdir(options.dir.c_str());
+    }
+
+    if (options.out.empty()) {
+        writeJson(std::cout, options, overhead, results);
+    } else {
+        std::ofstream out(options.out);
+        writeJson(out, options, overhead, results);
+        if (!out) {
+            std::cerr << "Error writing " << options.out << std::endl;
+            return 1;
+        }
+        std::cerr << "Results written to " << options.out << std::endl;
+    }
+    return 0;
+}
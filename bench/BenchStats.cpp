@@ -0,0 +1,67 @@
+#include "BenchStats.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+} // namespace
+
+double nanosSince(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+}
+
+BenchResult summarize(const std::string& name, std::vector<double>& nanos, size_t itemsPerSample,
+                      uint64_t bytesPerSample) {
+    BenchResult result;
+    result.name = name;
+    result.samples = nanos.size();
+    result.itemsPerSample = itemsPerSample;
+    result.p50 = result.p99 = result.mean = result.max = result.throughput = result.megabytesPerSecond = 0.0;
+    result.memoryMeasured = false;
+    result.rssGrowthKb = 0;
+    if (nanos.empty()) return result;
+
+    std::sort(nanos.begin(), nanos.end());
+    double total = 0.0;
+    for (double sample : nanos) total += sample;
+    result.p50 = percentile(nanos, 0.50);
+    result.p99 = percentile(nanos, 0.99);
+    result.mean = total / nanos.size();
+    result.max = nanos.back();
+    result.throughput = total > 0.0 ? static_cast<double>(nanos.size()) * itemsPerSample * 1e9 / total : 0.0;
+    result.megabytesPerSecond = total > 0.0 ? static_cast<double>(nanos.size()) * bytesPerSample * 1e3 / total : 0.0;
+    return result;
+}
+
+void writeResultJson(std::ostream& out, const BenchResult& r) {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1)
+        << "{\"name\": \"" << r.name << "\", \"samples\": " << r.samples
+        << ", \"items_per_sample\": " << r.itemsPerSample
+        << ", \"p50_ns\": " << r.p50 << ", \"p99_ns\": " << r.p99
+        << ", \"mean_ns\": " << r.mean << ", \"max_ns\": " << r.max
+        << ", \"throughput_per_sec\": " << r.throughput;
+    if (r.megabytesPerSecond > 0.0) out << ", \"mb_per_sec\": " << r.megabytesPerSecond;
+    if (r.memoryMeasured) out << ", \"rss_growth_kb\": " << r.rssGrowthKb;
+    out << "}";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void printSummary(const BenchResult& r) {
+    std::cerr << std::left << std::setw(54) << r.name << std::right << std::fixed << std::setprecision(0)
+              << " p50 " << std::setw(12) << r.p50 << " ns  p99 " << std::setw(12) << r.p99
+              << " ns  " << std::setw(12) << r.throughput << " /s";
+    if (r.megabytesPerSecond > 0.0) std::cerr << std::setprecision(1) << "  " << r.megabytesPerSecond << " MB/s";
+    if (r.memoryMeasured) std::cerr << "  RSS " << std::showpos << r.rssGrowthKb << std::noshowpos << " KB";
+    std::cerr << std::endl;
+}
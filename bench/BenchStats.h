@@ -0,0 +1,38 @@
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+// Latency summary shared by the benchmark tools (bank_bench, bank_replay)
+
+typedef std::chrono::steady_clock BenchClock;
+
+double nanosSince(BenchClock::time_point start);
+
+struct BenchResult {
+    std::string name;
+    size_t samples;
+    size_t itemsPerSample;      // Rows/accounts handled by one call (1 for single operations)
+    double p50;                 // Nanoseconds
+    double p99;
+    double mean;
+    double max;
+    double throughput;          // Items per second over the summed call time
+    double megabytesPerSecond;  // Bytes written or read per second (0 if not measured)
+    bool memoryMeasured;
+    int64_t rssGrowthKb;        // Resident set growth over the run (if memoryMeasured)
+};
+
+// Sorts nanos and summarizes them (nearest-rank percentiles)
+BenchResult summarize(const std::string& name, std::vector<double>& nanos, size_t itemsPerSample = 1,
+                      uint64_t bytesPerSample = 0);
+
+void writeResultJson(std::ostream& out, const BenchResult& result);   // One JSON object, no newline
+void printSummary(const BenchResult& result);                         // One human-readable line on std::cerr
+
+#endif // BENCH_STATS_H
@@ -0,0 +1,189 @@
+/**
+ * Compares the tagged (statically dispatched) account kinds with the virtual
+ * hierarchy they replaced, on the two paths bulk operations take:
+ *  - picking savings accounts out of every account (interest sweep)
+ *  - withdrawing through the account interface (batches)
+ *
+ * Usage: bench_dispatch [accounts]   (default 1000000)
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include "../include/utils/AccountPool.h"
+
+namespace {
+
+// The previous hierarchy, reduced to what the sweep and batch paths touched
+class LegacyAccount {
+protected:
+    std::string accountType;
+    Money balance;
+
+public:
+    LegacyAccount(const std::string& type, Money initialBalance) : accountType(type), balance(initialBalance) {}
+    virtual ~LegacyAccount() = default;
+
+    std::string getAccountType() const { return accountType; }   // Returned by value, as before
+    Money getBalance() const { return balance; }
+
+    virtual bool withdraw(Money amount) {
+        if (!amount.isPositive() || amount > balance) return false;
+        balance -= amount;
+        return true;
+    }
+};
+
+class LegacyChecking : public LegacyAccount {
+    Money transactionFee;
+
+public:
+    LegacyChecking(Money initialBalance, Money fee) : LegacyAccount("Checking", initialBalance), transactionFee(fee) {}
+
+    bool withdraw(Money amount) override {
+        Money total;
+        if (!amount.tryAdd(transactionFee, total)) return false;
+        return LegacyAccount::withdraw(total);
+    }
+};
+
+class LegacySavings : public LegacyAccount {
+    InterestRate interestRate;
+
+public:
+    LegacySavings(Money initialBalance, InterestRate rate) : LegacyAccount("Savings", initialBalance), interestRate(rate) {}
+    InterestRate getInterestRate() const { return interestRate; }
+};
+
+// Same reduced shape, dispatched on the kind tag like Account
+struct TaggedAccount {
+    Account::Kind kind;
+    Money balance;
+    Money transactionFee;
+    InterestRate interestRate;
+
+    bool withdraw(Money amount) {
+        if (!amount.isPositive()) return false;
+        if (kind == Account::CHECKING && !amount.tryAdd(transactionFee, amount)) return false;
+        if (amount > balance) return false;
+        balance -= amount;
+        return true;
+    }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, double legacySeconds, double taggedSeconds, size_t operations) {
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << legacySeconds * 1e9 / operations << " ns/op  virtual"
+              << std::setw(10) << taggedSeconds * 1e9 / operations << " ns/op  tagged"
+              << std::setw(8) << (taggedSeconds > 0 ? legacySeconds / taggedSeconds : 0.0) << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = (argc >= 2) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+    if (count == 0) count = 1;
+
+    // Kinds are shuffled so neither side gets a perfectly predictable branch
+    std::mt19937 random(42);
+    std::vector<Account::Kind> kinds(count);
+    for (size_t i = 0; i < count; ++i) {
+        kinds[i] = (i % 2 == 0) ? Account::SAVINGS : Account::CHECKING;
+    }
+    std::shuffle(kinds.begin(), kinds.end(), random);
+
+    Money balance = Money::fromCents(100000000);
+    Money fee = Money::fromCents(CheckingAccount::DEFAULT_FEE_CENTS);
+    InterestRate rate = InterestRate::fromMicros(SavingsAccount::DEFAULT_RATE_MICROS);
+
+    // Real accounts for the sweep selection, in both the old and the new style
+    AccountPool pool;
+    std::vector<Account*> accounts;
+    accounts.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string id = AccountId(static_cast<uint32_t>(10000 + i)).toString();
+        if (kinds[i] == Account::SAVINGS) {
+            accounts.push_back(pool.create<SavingsAccount>(id, "Customer", balance, "pw", rate));
+        } else {
+            accounts.push_back(pool.create<CheckingAccount>(id, "Customer", balance, "pw", fee));
+        }
+    }
+
+    std::vector<LegacyAccount*> legacy;
+    std::vector<TaggedAccount> tagged(count);
+    legacy.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (kinds[i] == Account::SAVINGS) {
+            legacy.push_back(new LegacySavings(balance, rate));
+        } else {
+            legacy.push_back(new LegacyChecking(balance, fee));
+        }
+        tagged[i].kind = kinds[i];
+        tagged[i].balance = balance;
+        tagged[i].transactionFee = fee;
+        tagged[i].interestRate = rate;
+    }
+
+    std::cout << "Accounts: " << count << std::endl;
+
+    // 1. Sweep selection: find every savings account and read its rate
+    int64_t legacyRates = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (Account* acc : accounts) {
+        if (acc->getAccountType() == std::string("Savings")) {
+            legacyRates += static_cast<SavingsAccount*>(acc)->getInterestRate().getMicros();
+        }
+    }
+    double legacySeconds = secondsSince(start);
+
+    int64_t taggedRates = 0;
+    start = std::chrono::steady_clock::now();
+    for (Account* acc : accounts) {
+        if (acc->getKind() == Account::SAVINGS) {
+            taggedRates += static_cast<SavingsAccount*>(acc)->getInterestRate().getMicros();
+        }
+    }
+    double taggedSeconds = secondsSince(start);
+    report("sweep selection", legacySeconds, taggedSeconds, count);
+
+    // 2. Withdrawals through the account interface
+    Money amount = Money::fromCents(1);
+    size_t legacyOk = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (LegacyAccount* acc : legacy) {
+            legacyOk += acc->withdraw(amount) ? 1 : 0;
+        }
+    }
+    legacySeconds = secondsSince(start);
+
+    size_t taggedOk = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 10; ++round) {
+        for (TaggedAccount& acc : tagged) {
+            taggedOk += acc.withdraw(amount) ? 1 : 0;
+        }
+    }
+    taggedSeconds = secondsSince(start);
+    report("withdraw dispatch", legacySeconds, taggedSeconds, count * 10);
+
+    // Keep the results observable so the loops aren't optimised away
+    if (legacyRates != taggedRates || legacyOk != taggedOk) {
+        std::cerr << "Mismatch between the two representations" << std::endl;
+        return 1;
+    }
+
+    for (LegacyAccount* acc : legacy) {
+        delete acc;
+    }
+    return 0;
+}
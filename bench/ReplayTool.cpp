@@ -0,0 +1,464 @@
+/**
+ * Workload replay: re-issues a recorded stream of deposits and withdrawals
+ * (a transactions.csv file or a journal) against a fresh BankSystem, for
+ * capacity planning with real traffic shapes.
+ *
+ * Operations run either as fast as possible or paced at N times real time by
+ * their recorded timestamps, on one or more client threads. Each account's
+ * operations stay on one thread in recorded order, so a withdrawal never
+ * overtakes the deposit that funded it. Every call is timed and reported per
+ * operation type (p50/p99/mean/max, throughput) as JSON, followed by a
+ * balance-conservation check of the bank after the run:
+ *
+ *   final total = initial total + deposits - withdrawals - fees + interest
+ *
+ * and a scan for negative balances. The exit status is 2 if a check fails.
+ *
+ * The bank starts from --accounts (copied, never modified) or, without it,
+ * from accounts synthesized for every ID the recording touches: the accounts
+ * a replayed journal creates keep their recorded type and opening balance,
+ * any other account opens with --opening-balance.
+ *
+ * Usage: bank_replay [--transactions file.csv | --journal file] [--accounts file.csv]
+ *                    [--opening-balance amount] [--speed N] [--threads N] [--limit N]
+ *                    [--dir path] [--out file.json] [--keep-data]
+ *
+ *   --transactions     recorded transactions (default data/transactions.csv)
+ *   --journal          replay the deposits/withdrawals of a journal instead
+ *   --accounts         accounts file to start from (default: synthesized)
+ *   --opening-balance  balance of synthesized accounts (default 0.00)
+ *   --speed            0 = as fast as possible (default), N = N times real time
+ *   --threads          client threads (default 1)
+ *   --limit            replay only the first N operations
+ *   --dir              scratch directory for the bank's files (default replay_data)
+ *   --out              JSON output file (default: standard output)
+ *   --keep-data        leave the bank's files in --dir
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../include/Bank System/BankSystem.h"
+#include "BenchStats.h"
+
+namespace {
+
+struct Options {
+    std::string transactions;
+    std::string journal;
+    std::string accounts;
+    Money openingBalance;
+    double speed;
+    unsigned threads;
+    size_t limit;
+    std::string dir;
+    std::string out;
+    bool keepData;
+
+    Options() : transactions("data/transactions.csv"), speed(0.0), threads(1), limit(0),
+                dir("replay_data"), keepData(false) {}
+};
+
+struct ReplayOp {
+    std::string accountId;
+    uint32_t account;
+    bool deposit;
+    Money amount;
+    std::time_t time;
+};
+
+// Account synthesized for the fresh bank when no accounts file is given
+struct SeedAccount {
+    std::string type;
+    Money balance;
+    Money fee;
+    InterestRate rate;
+};
+
+// What one client thread did
+struct ThreadTotals {
+    std::vector<double> depositNanos;
+    std::vector<double> withdrawNanos;
+    std::vector<double> lagNanos;      // How late each paced call started
+    Money deposited;
+    Money withdrawn;
+    Money fees;
+    size_t rejectedUnknown;            // Account not in the bank
+    size_t rejectedFunds;              // Withdrawal over the balance (or amount not accepted)
+
+    ThreadTotals() : rejectedUnknown(0), rejectedFunds(0) {}
+};
+
+struct Conservation {
+    Money initial;
+    Money deposited;
+    Money withdrawn;
+    Money fees;
+    Money interest;
+    Money expected;
+    Money final;
+    size_t negativeAccounts;
+
+    bool holds() const { return expected == final && negativeAccounts == 0; }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--keep-data") {
+            options.keepData = true;
+        } else if (arg == "--transactions" && hasValue) {
+            options.transactions = argv[++i];
+        } else if (arg == "--journal" && hasValue) {
+            options.journal = argv[++i];
+        } else if (arg == "--accounts" && hasValue) {
+            options.accounts = argv[++i];
+        } else if (arg == "--opening-balance" && hasValue) {
+            if (!Money::parse(std::string(argv[++i]), options.openingBalance) || options.openingBalance.isNegative()) {
+                return false;
+            }
+        } else if (arg == "--speed" && hasValue) {
+            options.speed = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--limit" && hasValue) {
+            options.limit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--dir" && hasValue) {
+            options.dir = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            options.out = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.threads > 0 && options.speed >= 0.0;
+}
+
+bool copyFile(const std::string& from, const std::string& to) {
+    std::ifstream in(from, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error opening " << from << std::endl;
+        return false;
+    }
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    out << in.rdbuf();
+    if (!out) {
+        std::cerr << "Error writing " << to << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void addOp(std::vector<ReplayOp>& ops, AccountId account, bool deposit, Money amount, std::time_t time) {
+    ReplayOp op;
+    op.accountId = account.toString();
+    op.account = account.getValue();
+    op.deposit = deposit;
+    op.amount = amount;
+    op.time = time;
+    ops.push_back(op);
+}
+
+void loadFromTransactions(const std::string& path, std::vector<ReplayOp>& ops) {
+    std::vector<Transaction> transactions;
+    FileHandler files("", path);
+    files.loadTransactions(transactions);
+    ops.reserve(transactions.size());
+    for (const Transaction& trans : transactions) {
+        addOp(ops, trans.getAccountId(), trans.getType() == Transaction::DEPOSIT,
+              trans.getAmount(), trans.getTimestamp());
+    }
+}
+
+// Reads a copy of the journal (replay may truncate or upgrade the file it reads)
+bool loadFromJournal(const std::string& path, const std::string& scratch, std::vector<ReplayOp>& ops,
+                     std::map<uint32_t, SeedAccount>& seeds) {
+    if (!copyFile(path, scratch)) return false;
+    {
+        Journal journal(scratch);
+        journal.replay([&](const Journal::Record& record) {
+            AccountId account = AccountId::fromString(record.accountId);
+            if (!account.isValid()) return;
+            if (record.type == Journal::DEPOSIT || record.type == Journal::WITHDRAWAL) {
+                // Recorded withdrawal amounts exclude the fee, as in the transactions file
+                addOp(ops, account, record.type == Journal::DEPOSIT, record.amount,
+                      static_cast<std::time_t>(record.timestamp));
+            } else if (record.type == Journal::CREATE_ACCOUNT) {
+                SeedAccount& seed = seeds[account.getValue()];
+                seed.type = record.accountType;
+                seed.balance = record.balance;
+                seed.fee = record.transactionFee;
+                seed.rate = record.interestRate;
+            }
+        });
+    }
+    ::unlink(scratch.c_str());
+    return true;
+}
+
+// Accounts file for every account the recording touches; savings accounts are
+// accrued through now, so the replay itself posts interest only across midnight
+bool writeSeedAccounts(const std::string& path, const std::vector<ReplayOp>& ops,
+                       std::map<uint32_t, SeedAccount>& seeds, Money openingBalance) {
+    for (const ReplayOp& op : ops) {
+        if (seeds.find(op.account) == seeds.end()) {
+            SeedAccount& seed = seeds[op.account];
+            seed.type = "Replay";
+            seed.balance = openingBalance;
+        }
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    std::string now = std::to_string(static_cast<long long>(std::time(nullptr)));
+    for (const auto& entry : seeds) {
+        const SeedAccount& seed = entry.second;
+        out << AccountId(entry.first).toString() << ",Replay " << entry.first << ',' << seed.type << ','
+            << seed.balance.toString() << ",Replay#Pass1";
+        if (seed.type == "Checking") {
+            out << ',' << seed.fee.toString();
+        } else if (seed.type == "Savings") {
+            out << ',' << seed.rate.toString() << ',' << now << ",0";
+        }
+        out << '\n';
+    }
+    if (!out) {
+        std::cerr << "Error writing " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Replays one thread's share of ops (indices in recorded order)
+void replayPart(BankSystem& bank, const std::vector<ReplayOp>& ops, const std::vector<size_t>& mine,
+                const std::unordered_map<uint32_t, Money>& fees, double speed,
+                BenchClock::time_point start, std::time_t firstTime, ThreadTotals& totals) {
+    totals.depositNanos.reserve(mine.size());
+    totals.withdrawNanos.reserve(mine.size());
+    if (speed > 0.0) totals.lagNanos.reserve(mine.size());
+
+    for (size_t index : mine) {
+        const ReplayOp& op = ops[index];
+        if (speed > 0.0) {
+            double offset = static_cast<double>(op.time - firstTime) / speed;
+            BenchClock::time_point due = start + std::chrono::duration_cast<BenchClock::duration>(
+                                                     std::chrono::duration<double>(offset));
+            std::this_thread::sleep_until(due);
+            totals.lagNanos.push_back(std::max(0.0, nanosSince(due)));
+        }
+
+        BenchClock::time_point begin = BenchClock::now();
+        bool done = op.deposit ? bank.deposit(op.accountId, op.amount) : bank.withdraw(op.accountId, op.amount);
+        double nanos = nanosSince(begin);
+        (op.deposit ? totals.depositNanos : totals.withdrawNanos).push_back(nanos);
+
+        if (!done) {
+            if (fees.find(op.account) == fees.end()) {
+                ++totals.rejectedUnknown;
+            } else {
+                ++totals.rejectedFunds;
+            }
+        } else if (op.deposit) {
+            totals.deposited += op.amount;
+        } else {
+            totals.withdrawn += op.amount;
+            totals.fees += fees.find(op.account)->second;
+        }
+    }
+}
+
+void writeJson(std::ostream& out, const Options& options, size_t opCount, size_t accountCount,
+               double wallSeconds, size_t rejectedUnknown, size_t rejectedFunds,
+               const std::vector<BenchResult>& results, const Conservation& check) {
+    out << std::fixed << std::setprecision(1);
+    out << "{\n  \"schema\": 1,\n  \"config\": {\n"
+        << "    \"source\": \"" << (options.journal.empty() ? options.transactions : options.journal) << "\",\n"
+        << "    \"source_type\": \"" << (options.journal.empty() ? "transactions" : "journal") << "\",\n"
+        << "    \"accounts\": \"" << (options.accounts.empty() ? "synthesized" : options.accounts) << "\",\n"
+        << "    \"account_count\": " << accountCount << ",\n"
+        << "    \"ops\": " << opCount << ",\n"
+        << "    \"threads\": " << options.threads << ",\n"
+        << "    \"speed\": " << options.speed << ",\n"
+        << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "    \"compiler\": \"" << __VERSION__ << "\"\n  },\n"
+        << "  \"summary\": {\n"
+        << "    \"wall_seconds\": " << std::setprecision(3) << wallSeconds << ",\n"
+        << "    \"ops_per_sec\": " << std::setprecision(1) << (wallSeconds > 0.0 ? opCount / wallSeconds : 0.0) << ",\n"
+        << "    \"succeeded\": " << (opCount - rejectedUnknown - rejectedFunds) << ",\n"
+        << "    \"rejected_unknown_account\": " << rejectedUnknown << ",\n"
+        << "    \"rejected_insufficient_funds\": " << rejectedFunds << "\n  },\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        out << "    ";
+        writeResultJson(out, results[i]);
+        out << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"conservation\": {\n"
+        << "    \"initial_total\": \"" << check.initial.toString() << "\",\n"
+        << "    \"deposited\": \"" << check.deposited.toString() << "\",\n"
+        << "    \"withdrawn\": \"" << check.withdrawn.toString() << "\",\n"
+        << "    \"fees\": \"" << check.fees.toString() << "\",\n"
+        << "    \"interest_posted\": \"" << check.interest.toString() << "\",\n"
+        << "    \"expected_total\": \"" << check.expected.toString() << "\",\n"
+        << "    \"final_total\": \"" << check.final.toString() << "\",\n"
+        << "    \"negative_balances\": " << check.negativeAccounts << ",\n"
+        << "    \"ok\": " << (check.holds() ? "true" : "false") << "\n  }\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--transactions file.csv | --journal file] [--accounts file.csv]"
+                  << " [--opening-balance amount] [--speed N] [--threads N] [--limit N]"
+                  << " [--dir path] [--out file.json] [--keep-data]" << std::endl;
+        return 1;
+    }
+
+    ::mkdir(options.dir.c_str(), 0755);
+    std::string accFile = options.dir + "/accounts.csv";
+    std::string transFile = options.dir + "/transactions.csv";
+    std::string journalFile = options.dir + "/bank.journal";
+    std::string snapFile = options.dir + "/bank.snapshot";
+    ::unlink(transFile.c_str());
+    ::unlink(journalFile.c_str());
+    ::unlink(snapFile.c_str());
+    ::unlink((snapFile + ".ledger").c_str());
+
+    // 1. The recording, in time order (stable, so same-second operations keep file order)
+    std::vector<ReplayOp> ops;
+    std::map<uint32_t, SeedAccount> seeds;
+    if (options.journal.empty()) {
+        loadFromTransactions(options.transactions, ops);
+    } else if (!loadFromJournal(options.journal, options.dir + "/input.journal", ops, seeds)) {
+        return 1;
+    }
+    std::stable_sort(ops.begin(), ops.end(), [](const ReplayOp& a, const ReplayOp& b) {
+        return a.time < b.time;
+    });
+    if (options.limit > 0 && ops.size() > options.limit) ops.resize(options.limit);
+    if (ops.empty()) {
+        std::cerr << "No deposits or withdrawals to replay" << std::endl;
+        return 1;
+    }
+
+    // 2. A fresh bank over a scratch copy of the accounts
+    bool ready = options.accounts.empty() ? writeSeedAccounts(accFile, ops, seeds, options.openingBalance)
+                                          : copyFile(options.accounts, accFile);
+    if (!ready) return 1;
+    // Replay doesn't log in, so plaintext passwords in the accounts file are hashed at the lowest cost
+    BankSystem* bank = new BankSystem(accFile, transFile, journalFile, snapFile, 16, AccountId::MAX_VALUE,
+                                      PasswordHash::MIN_COST);
+    bank->applyInterestToAllSavingsAccounts();   // Settle old accruals before the baseline
+
+    // Withdrawal fee of every replayed account that exists (absent = unknown account)
+    std::unordered_map<uint32_t, Money> fees;
+    for (const ReplayOp& op : ops) {
+        if (fees.count(op.account) != 0) continue;
+        const Account* acc = bank->findAccount(op.accountId);
+        if (acc == nullptr) continue;
+        fees[op.account] = (acc->getKind() == Account::CHECKING)
+                               ? static_cast<const CheckingAccount*>(acc)->getTransactionFee() : Money();
+    }
+
+    // 3. The replay: accounts partitioned across threads, each thread in recorded order
+    std::vector<std::vector<size_t> > parts(options.threads);
+    for (size_t i = 0; i < ops.size(); ++i) {
+        parts[ops[i].account % options.threads].push_back(i);
+    }
+    std::vector<ThreadTotals> totals(options.threads);
+
+    Conservation check;
+    check.initial = bank->getTotalBalance();
+    Money interestBefore = bank->getInterestPosted();
+    std::cerr << "Replaying " << ops.size() << " operations on " << options.threads << " thread(s)";
+    if (options.speed > 0.0) std::cerr << " at " << options.speed << "x real time";
+    std::cerr << std::endl;
+
+    BenchClock::time_point start = BenchClock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < options.threads; ++t) {
+        workers.push_back(std::thread(replayPart, std::ref(*bank), std::cref(ops), std::cref(parts[t]),
+                                      std::cref(fees), options.speed, start, ops.front().time,
+                                      std::ref(totals[t])));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double wallSeconds = nanosSince(start) / 1e9;
+
+    // 4. Results and conservation
+    std::vector<double> depositNanos, withdrawNanos, lagNanos, allNanos;
+    size_t rejectedUnknown = 0, rejectedFunds = 0;
+    for (const ThreadTotals& part : totals) {
+        depositNanos.insert(depositNanos.end(), part.depositNanos.begin(), part.depositNanos.end());
+        withdrawNanos.insert(withdrawNanos.end(), part.withdrawNanos.begin(), part.withdrawNanos.end());
+        lagNanos.insert(lagNanos.end(), part.lagNanos.begin(), part.lagNanos.end());
+        check.deposited += part.deposited;
+        check.withdrawn += part.withdrawn;
+        check.fees += part.fees;
+        rejectedUnknown += part.rejectedUnknown;
+        rejectedFunds += part.rejectedFunds;
+    }
+    allNanos = depositNanos;
+    allNanos.insert(allNanos.end(), withdrawNanos.begin(), withdrawNanos.end());
+
+    std::vector<BenchResult> results;
+    results.push_back(summarize("replay.deposit", depositNanos));
+    results.push_back(summarize("replay.withdraw", withdrawNanos));
+    results.push_back(summarize("replay.all", allNanos));
+    if (options.speed > 0.0) results.push_back(summarize("replay.schedule_lag", lagNanos));
+    for (const BenchResult& result : results) {
+        printSummary(result);
+    }
+
+    check.interest = bank->getInterestPosted() - interestBefore;
+    check.final = bank->getTotalBalance();
+    check.expected = check.initial + check.deposited - check.withdrawn - check.fees + check.interest;
+    check.negativeAccounts = 0;
+    for (const auto& entry : fees) {
+        const Account* acc = bank->findAccount(AccountId(entry.first).toString());
+        if (acc != nullptr && acc->getBalance().isNegative()) ++check.negativeAccounts;
+    }
+    size_t accountCount = bank->getAccountCount();
+    std::cerr << "Throughput " << std::fixed << std::setprecision(0) << ops.size() / wallSeconds
+              << " ops/s over " << std::setprecision(3) << wallSeconds << " s; conservation "
+              << (check.holds() ? "holds" : "FAILED") << " (expected " << check.expected.toString()
+              << ", final " << check.final.toString() << ")" << std::endl;
+    delete bank;
+
+    if (!options.keepData) {
+        ::unlink(accFile.c_str());
+        ::unlink(transFile.c_str());
+        ::unlink(journalFile.c_str());
+        ::unlink(snapFile.c_str());
+        ::unlink((snapFile + ".ledger").c_str());
+    ::unlink((snapFile + ".ledger").c_str());
+        ::rmdir(options.dir.c_str());
+    }
+
+    if (options.out.empty()) {
+        writeJson(std::cout, options, ops.size(), accountCount, wallSeconds, rejectedUnknown, rejectedFunds,
+                  results, check);
+    } else {
+        std::ofstream out(options.out);
+        writeJson(out, options, ops.size(), accountCount, wallSeconds, rejectedUnknown, rejectedFunds,
+                  results, check);
+        if (!out) {
+            std::cerr << "Error writing " << options.out << std::endl;
+            return 1;
+        }
+        std::cerr << "Results written to " << options.out << std::endl;
+    }
+    return check.holds() ? 0 : 2;
+}
@@ -0,0 +1,247 @@
+/**
+ * Concurrency stress test: many sessions deposit into and withdraw from a
+ * small set of shared accounts at once, so every shard lock, the transaction
+ * log and the journal's group commit are contended, while another thread
+ * keeps checkpointing underneath them. Each session counts what it moved, and the
+ * bank must conserve money:
+ *
+ *   final total = initial total + deposits - withdrawals - fees
+ *
+ * The same total must come back after the bank is saved and loaded again,
+ * and no balance may be negative. The exit status is 2 if a check fails.
+ *
+ * Usage: bank_stress [--threads N] [--accounts N] [--ops N] [--seed N]
+ *                    [--checkpoint-ms N] [--dir path] [--keep-data]
+ *
+ *   --threads           concurrent sessions (default 8)
+ *   --accounts          checking accounts they share (default 64)
+ *   --ops               operations per session (default 5000)
+ *   --seed              random seed (default 1)
+ *   --checkpoint-ms     pause between checkpoints, 0 = no checkpoints (default 20)
+ *   --dir               scratch directory for the bank's files (default stress_data)
+ *   --keep-data         leave the bank's files in --dir
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../include/Bank System/BankSystem.h"
+#include "../include/utils/PasswordHash.h"
+
+namespace {
+
+const int64_t OPENING_CENTS = 100000;   // Every account opens with 1000.00
+const int64_t FEE_CENTS = 25;           // ... and pays 0.25 per withdrawal
+
+struct Options {
+    unsigned threads;
+    size_t accounts;
+    size_t ops;
+    unsigned seed;
+    unsigned checkpointMs;
+    std::string dir;
+    bool keepData;
+
+    Options() : threads(8), accounts(64), ops(5000), seed(1), checkpointMs(20),
+                dir("stress_data"), keepData(false) {}
+};
+
+// What one session moved
+struct SessionTotals {
+    Money deposited;
+    Money withdrawn;
+    Money fees;
+    size_t rejected;
+
+    SessionTotals() : rejected(0) {}
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--keep-data") {
+            options.keepData = true;
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--accounts" && hasValue) {
+            options.accounts = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--ops" && hasValue) {
+            options.ops = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--checkpoint-ms" && hasValue) {
+            options.checkpointMs = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--dir" && hasValue) {
+            options.dir = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.threads > 0 && options.accounts > 0;
+}
+
+std::string accountId(size_t index) {
+    return AccountId(static_cast<uint32_t>(AccountIdAllocator::DEFAULT_FIRST + index)).toString();
+}
+
+bool writeAccounts(const std::string& path, size_t count) {
+    std::ofstream out(path, std::ios::trunc);
+    Money opening = Money::fromCents(OPENING_CENTS);
+    Money fee = Money::fromCents(FEE_CENTS);
+    for (size_t i = 0; i < count; ++i) {
+        out << accountId(i) << ",Stress " << i << ",Checking," << opening.toString() << ",Stress#Pass1,"
+            << fee.toString() << '\n';
+    }
+    if (!out) {
+        std::cerr << "Error writing " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Random deposits and withdrawals (a third of them withdrawals) on random accounts
+void runSession(BankSystem& bank, const Options& options, unsigned session, SessionTotals& totals) {
+    std::mt19937 random(options.seed * 7919u + session);
+    std::uniform_int_distribution<size_t> pickAccount(0, options.accounts - 1);
+    std::uniform_int_distribution<int64_t> pickCents(1, 50000);
+    Money fee = Money::fromCents(FEE_CENTS);
+
+    for (size_t i = 0; i < options.ops; ++i) {
+        std::string id = accountId(pickAccount(random));
+        Money amount = Money::fromCents(pickCents(random));
+        if (random() % 3 != 0) {
+            if (bank.deposit(id, amount)) {
+                totals.deposited += amount;
+            } else {
+                ++totals.rejected;
+            }
+        } else if (bank.withdraw(id, amount)) {
+            totals.withdrawn += amount;
+            totals.fees += fee;
+        } else {
+            ++totals.rejected;   // Insufficient funds
+        }
+    }
+}
+
+// Checkpoints until the sessions are done (the persister would wait for an idle CPU)
+void runCheckpoints(BankSystem& bank, unsigned pauseMs, const std::atomic<bool>& done, size_t& failed) {
+    while (!done.load()) {
+        if (!bank.checkpoint()) ++failed;
+        std::this_thread::sleep_for(std::chrono::milliseconds(pauseMs));
+    }
+}
+
+size_t countNegative(BankSystem& bank, size_t accounts) {
+    size_t negative = 0;
+    for (size_t i = 0; i < accounts; ++i) {
+        const Account* acc = bank.findAccount(accountId(i));
+        if (acc != nullptr && acc->getBalance().isNegative()) ++negative;
+    }
+    return negative;
+}
+
+bool check(const char* what, bool ok) {
+    std::cout << (ok ? "ok     " : "FAILED ") << what << std::endl;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--threads N] [--accounts N] [--ops N] [--seed N]"
+                  << " [--checkpoint-ms N] [--dir path] [--keep-data]" << std::endl;
+        return 1;
+    }
+
+    ::mkdir(options.dir.c_str(), 0755);
+    std::string accFile = options.dir + "/accounts.csv";
+    std::string transFile = options.dir + "/transactions.csv";
+    std::string journalFile = options.dir + "/bank.journal";
+    std::string snapFile = options.dir + "/bank.snapshot";
+    const char* const files[] = {"accounts.csv", "accounts.csv.delta", "transactions.csv", "bank.journal",
+                                 "bank.journal.sealed", "bank.snapshot", "bank.snapshot.ledger"};
+    for (const char* file : files) {
+        ::unlink((options.dir + "/" + file).c_str());
+    }
+    if (!writeAccounts(accFile, options.accounts)) return 1;
+
+    // Nobody logs in, so the plaintext passwords are hashed at the lowest cost
+    BankSystem* bank = new BankSystem(accFile, transFile, journalFile, snapFile, 16,
+                                      AccountIdAllocator::DEFAULT_LAST, PasswordHash::MIN_COST);
+    Money initial = bank->getTotalBalance();
+
+    std::cout << "Running " << options.threads << " sessions x " << options.ops << " operations on "
+              << options.accounts << " accounts" << std::endl;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<SessionTotals> totals(options.threads);
+    std::vector<std::thread> sessions;
+    std::atomic<bool> done(false);
+    size_t failedCheckpoints = 0;
+    std::thread checkpointer;
+    if (options.checkpointMs > 0) {
+        checkpointer = std::thread(runCheckpoints, std::ref(*bank), options.checkpointMs, std::cref(done),
+                                   std::ref(failedCheckpoints));
+    }
+    for (unsigned t = 0; t < options.threads; ++t) {
+        sessions.push_back(std::thread(runSession, std::ref(*bank), std::cref(options), t, std::ref(totals[t])));
+    }
+    for (std::thread& session : sessions) {
+        session.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    done = true;
+    if (checkpointer.joinable()) checkpointer.join();
+
+    Money deposited, withdrawn, fees;
+    size_t rejected = 0;
+    for (const SessionTotals& part : totals) {
+        deposited += part.deposited;
+        withdrawn += part.withdrawn;
+        fees += part.fees;
+        rejected += part.rejected;
+    }
+    Money expected = initial + deposited - withdrawn - fees;
+    Money final = bank->getTotalBalance();
+    size_t transactions = bank->getTransactionCount();
+    size_t succeeded = static_cast<size_t>(options.threads) * options.ops - rejected;
+    BankSystem::PersistenceStats persistence = bank->getPersistenceStats();
+
+    std::cout << succeeded << " operations (" << rejected << " turned down) in " << seconds << " s, "
+              << persistence.checkpoints << " checkpoint(s)\n"
+              << "initial " << initial.toString() << " + deposited " << deposited.toString()
+              << " - withdrawn " << withdrawn.toString() << " - fees " << fees.toString()
+              << " = expected " << expected.toString() << ", final " << final.toString() << std::endl;
+
+    bool ok = check("balance conservation", final == expected);
+    ok = check("one ledger row per operation", transactions == succeeded) && ok;
+    ok = check("no negative balances", countNegative(*bank, options.accounts) == 0) && ok;
+    ok = check("checkpoints succeeded", failedCheckpoints == 0) && ok;
+
+    // The saved files must hold the same bank
+    delete bank;
+    bank = new BankSystem(accFile, transFile, journalFile, snapFile, 16,
+                          AccountIdAllocator::DEFAULT_LAST, PasswordHash::MIN_COST);
+    ok = check("total after reload", bank->getTotalBalance() == expected) && ok;
+    ok = check("ledger after reload", bank->getTransactionCount() == transactions) && ok;
+    delete bank;
+
+    if (!options.keepData) {
+        for (const char* file : files) {
+            ::unlink((options.dir + "/" + file).c_str());
+        }
+        ::rmdir(options.dir.c_str());
+    }
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,150 @@
+#include "SyntheticData.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include "../include/System details/AccountId.h"
+#include "../include/System details/Money.h"
+#include "../include/System details/Transaction.h"
+#include "../include/System details/CheckingAccount.h"
+
+namespace {
+
+const size_t FLUSH_BYTES = 1 << 20;
+const int64_t SECONDS_PER_DAY = 86400;
+const int64_t TRANSACTION_ID_EPOCH = 1704067200;   // 2024-01-01 UTC, as in TransactionId::generate()
+
+// Buffered file writer; raw engine output only (std distributions differ between
+// standard libraries, which would make the files depend on the compiler)
+class CsvWriter {
+    std::ofstream file;
+    std::string buffer;
+    std::string path;
+
+public:
+    explicit CsvWriter(const std::string& filePath) : file(filePath, std::ios::binary | std::ios::trunc), path(filePath) {
+        buffer.reserve(FLUSH_BYTES + Transaction::MAX_CSV_LENGTH + 256);
+    }
+
+    bool isOpen() const { return file.is_open(); }
+    std::string& line() { return buffer; }
+
+    void endLine() {
+        buffer += '\n';
+        if (buffer.size() >= FLUSH_BYTES) flush();
+    }
+
+    void flush() {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    bool close() {
+        flush();
+        file.close();
+        if (!file) {
+            std::cerr << "Error writing " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+void appendMoney(std::string& out, Money amount) {
+    char text[Money::MAX_TEXT_LENGTH];
+    out.append(text, amount.format(text));
+}
+
+void appendPassword(std::string& out, std::mt19937_64& random) {
+    static const char* const CLASSES[] = {"abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+                                          "0123456789", "!@#$%^&*()-_=+"};
+    static const size_t CLASS_SIZES[] = {26, 26, 10, 14};
+    size_t length = 6 + random() % 11;
+    for (size_t i = 0; i < length; ++i) {
+        size_t cls = random() % 4;
+        out += CLASSES[cls][random() % CLASS_SIZES[cls]];
+    }
+}
+
+bool writeAccounts(const SyntheticDataConfig& config, std::mt19937_64& random, const std::string& accFile) {
+    CsvWriter out(accFile);
+    if (!out.isOpen()) {
+        std::cerr << "Error opening " << accFile << std::endl;
+        return false;
+    }
+
+    std::string accruedThrough = std::to_string(static_cast<long long>(config.asOf -
+                                                config.accrualDays * SECONDS_PER_DAY));
+    for (size_t i = 0; i < config.accounts; ++i) {
+        bool savings = (random() & 1) != 0;
+        std::string& line = out.line();
+        line += syntheticAccountId(i);
+        line += ",Customer ";
+        line += std::to_string(static_cast<unsigned long long>(i));
+        line += savings ? ",Savings," : ",Checking,";
+        appendMoney(line, Money::fromCents(static_cast<int64_t>(random() % 10000000)));
+        line += ',';
+        appendPassword(line, random);
+        line += ',';
+        if (savings) {
+            // 0.5% to 5% a year in steps of 0.25%
+            line += InterestRate::fromMicros(5000 + static_cast<int64_t>(random() % 19) * 2500).toString();
+            line += ',';
+            line += accruedThrough;
+            line += ",0";
+        } else {
+            appendMoney(line, Money::fromCents(CheckingAccount::DEFAULT_FEE_CENTS));
+        }
+        out.endLine();
+    }
+    return out.close();
+}
+
+bool writeTransactions(const SyntheticDataConfig& config, std::mt19937_64& random, const std::string& transFile) {
+    CsvWriter out(transFile);
+    if (!out.isOpen()) {
+        std::cerr << "Error opening " << transFile << std::endl;
+        return false;
+    }
+
+    int64_t start = static_cast<int64_t>(config.asOf) - 365 * SECONDS_PER_DAY;
+    int64_t span = 365 * SECONDS_PER_DAY;
+    char text[Transaction::MAX_CSV_LENGTH];
+    for (size_t i = 0; i < config.transactions; ++i) {
+        // Evenly spread, so the file is already in time order
+        int64_t time = start + static_cast<int64_t>(static_cast<double>(span) * i / config.transactions);
+
+        // Snowflake layout with distinct (millisecond, low bits) pairs: unique for any realistic count
+        uint64_t millis = static_cast<uint64_t>(time - TRANSACTION_ID_EPOCH) * 1000 + i % 1000;
+        TransactionId id((millis << 22) | (i & 0x3FFFFF));
+
+        AccountId account(SYNTHETIC_FIRST_ACCOUNT + static_cast<uint32_t>(random() % config.accounts));
+        Transaction::Type type = (random() % 10 < 7) ? Transaction::DEPOSIT : Transaction::WITHDRAWAL;
+        Money amount = Money::fromCents(1 + static_cast<int64_t>(random() % 50000));
+
+        Transaction trans(id, account, type, amount, static_cast<std::time_t>(time));
+        out.line().append(text, trans.formatCSV(text));
+        out.endLine();
+    }
+    return out.close();
+}
+
+} // namespace
+
+std::string syntheticAccountId(size_t index) {
+    return AccountId(SYNTHETIC_FIRST_ACCOUNT + static_cast<uint32_t>(index)).toString();
+}
+
+bool generateSyntheticData(const SyntheticDataConfig& config,
+                           const std::string& accFile, const std::string& transFile) {
+    if (config.accounts == 0 ||
+        config.accounts > AccountId::MAX_VALUE - SYNTHETIC_FIRST_ACCOUNT) {
+        std::cerr << "Account count out of range: " << config.accounts << std::endl;
+        return false;
+    }
+
+    // Separate streams, so changing the transaction count leaves the accounts unchanged
+    std::mt19937_64 accountRandom(config.seed);
+    std::mt19937_64 transactionRandom(config.seed ^ 0x9E3779B97F4A7C15ULL);
+    return writeAccounts(config, accountRandom, accFile) &&
+           writeTransactions(config, transactionRandom, transFile);
+}
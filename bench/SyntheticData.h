@@ -0,0 +1,42 @@
+#ifndef SYNTHETIC_DATA_H
+#define SYNTHETIC_DATA_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+
+/**
+ * Seeded generator of bank data files for the benchmarks.
+ *
+ * Writes accounts and transactions in exactly the CSV formats FileHandler
+ * reads, so every load/save path can be measured on 10K-10M accounts. The
+ * output depends only on the configuration: the same seed and asOf time
+ * always produce byte-identical files.
+ *
+ *  - Account i is "ACC" + (10000 + i); half of them (at random) are savings
+ *    accounts whose interest is accrued through accrualDays before asOf.
+ *  - Transactions hit uniformly random accounts, 70% deposits, spread in
+ *    time order over the year before asOf, with unique IDs.
+ */
+struct SyntheticDataConfig {
+    size_t accounts;
+    size_t transactions;
+    uint64_t seed;
+    std::time_t asOf;
+    int accrualDays;        // Days of interest savings accounts still have to accrue
+
+    SyntheticDataConfig()
+        : accounts(100000), transactions(1000000), seed(42), asOf(std::time(nullptr)), accrualDays(30) {}
+};
+
+const uint32_t SYNTHETIC_FIRST_ACCOUNT = 10000;
+
+// Writes both files; returns false (with a message on std::cerr) if either can't be written
+bool generateSyntheticData(const SyntheticDataConfig& config,
+                           const std::string& accFile, const std::string& transFile);
+
+// Text ID of account index (0-based) in generated data
+std::string syntheticAccountId(size_t index);
+
+#endif // SYNTHETIC_DATA_H
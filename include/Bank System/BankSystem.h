@@ -4,30 +4,162 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
 #include "../System details/Account.h"
 #include "../System details/CheckingAccount.h"
 #include "../System details/SavingsAccount.h"
 #include "../System details/Transaction.h"
+#include "../System details/AccountId.h"
+#include "../System details/Money.h"
+#include "../utils/AccountIndex.h"
+#include "../utils/AccountPool.h"
+#include "../utils/AccountIdAllocator.h"
 #include "../utils/FileHandler.h"
+#include "../utils/Journal.h"
+#include "../utils/Snapshot.h"
+#include "../utils/LatencyStats.h"
+#include "../utils/PasswordHash.h"
+#include "../utils/PasswordVerifier.h"
+#include "../utils/LoginThrottle.h"
+#include "TransactionLog.h"
+
+// One entry of a headless batch (see BankSystem::applyBatch)
+struct BatchOperation {
+    enum Type { DEPOSIT, WITHDRAW, CREATE, CLOSE, INVALID };
+
+    Type type;
+    std::string accountId;     // Target account (unused for CREATE)
+    Money amount;              // Deposit/withdrawal amount or initial balance for CREATE
+    std::string customerName;  // CREATE only
+    std::string accountType;   // CREATE only: "Checking" or "Savings"
+    std::string password;      // CREATE and CLOSE
+
+    BatchOperation() : type(INVALID) {}
+};
+
+struct BatchResult {
+    bool success;
+    std::string accountId;     // Account affected (the new ID for CREATE)
+    Money balance;             // Balance after the operation
+    const char* message;       // Failure reason, empty on success
+};
+
+// One page of an account statement (see BankSystem::getStatement)
+struct StatementPage {
+    std::vector<Transaction> transactions;  // In time order
+    std::string nextPageToken;              // Pass back for the next page; empty on the last page
+};
 
 class BankSystem {
 private:
-    std::map<std::string, Account*> accounts;
-    std::vector<Transaction> allTransactions;
+    // Accounts are partitioned by ID into independently locked shards, so
+    // sessions touching different accounts never wait on each other.
+    // Lock order: shards in index order, then the transaction log / journal.
+    struct AccountShard {
+        std::mutex mutex;
+        AccountIndex accounts;
+        std::unordered_set<uint32_t> changed;   // Created, changed or closed since the last save
+    };
+
+    AccountPool accountPool;          // Owns every account object; released in bulk on shutdown
+    std::vector<std::unique_ptr<AccountShard> > shards;
+    AccountIdAllocator idAllocator;
+    TransactionLog allTransactions;
     FileHandler fileHandler;
+    Journal journal;
+    Snapshot snapshot;
+    PasswordVerifier passwordVerifier; // Runs every password hash and check off the shard locks
+    unsigned passwordCost;            // PasswordHash cost of new hashes; logins rehash credentials at another cost
+    LoginThrottle loginThrottle;      // Bank-wide limit on failed logins, checked before any account lookup
+    size_t persistedTransactionCount; // Transactions already present in the transactions file
+    bool accountChangesValid;         // The account change segment continues the loaded files
+    bool ledgerInSync;                // The snapshot's ledger file holds the transactions file's rows
+
+    // Incremental saves and checkpoints append the changed accounts to the change segment; once
+    // it would hold a quarter of all accounts (at least MIN_MERGE_ROWS rows) everything is written
+    // out again
+    static const size_t MIN_MERGE_ROWS = 4096;
+    void markChanged(AccountId id);   // Mutator: Queues an account for the next save (shard locked)
+    bool needsFullSave(size_t accountCount, size_t changedCount) const;  // Accessor: Whether the next save rewrites everything
+    bool saveChanges();               // Mutator: Incremental save (all shards locked)
+    bool saveAll();                   // Mutator: Full save (all shards locked)
+    void appendToLedger(const Transaction* rows, size_t count, size_t firstRow);  // Mutator: Mirrors rows just appended to the transactions file
+    std::atomic<int64_t> interestPostedCents;  // Interest credited by accrual since start-up
+#ifdef BANK_STATS
+    LatencyStats latencyStats;        // Call counts and latency histograms of the public operations
+#endif
+
+    // Background persistence: checkpoints and full saves are serialized by persistMutex,
+    // taken before any shard lock
+    std::mutex persistMutex;
+    std::thread persister;
+    std::mutex persisterMutex;
+    std::condition_variable persisterWake;
+    bool persisterStopping;
+    std::chrono::seconds checkpointInterval;           // 0: no time trigger
+    std::atomic<uint64_t> checkpointMutations;         // 0: no mutation-count trigger
+    std::atomic<uint64_t> mutationsSinceCheckpoint;
+    uint64_t checkpointJournalBytes;                   // 0: no journal-size trigger
+    mutable std::mutex checkpointStatsMutex;           // Guards the four checkpoint counters below
+    uint64_t checkpointCount;
+    double lastCheckpointSeconds;
+    double totalCheckpointSeconds;
+    uint64_t foldedJournalBytes;
+    void persisterLoop();                              // Persister thread body
+    void noteMutation();                               // Mutator: Counts a journaled mutation for the persister
+
+    void applyJournalRecord(const Journal::Record& record,
+                            const std::unordered_set<uint64_t>& persistedIds);  // Mutator: Re-applies one journaled mutation
+    // Journal helpers return the record's sequence number; callers sync when ready
+    uint64_t journalTransaction(const Account* acc, const Transaction& trans);  // Mutator: Logs a deposit/withdrawal
+    uint64_t journalAccountCreated(const Account* acc);          // Mutator: Logs a new account
+    uint64_t journalAccountClosed(const std::string& accountId); // Mutator: Logs a closed account
+
+    // Lazy interest: savings accounts accrue up to now whenever they are read or changed (the files keep the accrual state)
+    uint64_t accrueInterest(Account* acc, std::time_t now);      // Mutator: One account (shard locked)
+    void accrueAllSavingsAccounts(std::time_t now);              // Mutator: Every account (all shards locked)
+
+    uint64_t recordTransaction(const Account* acc, Money amount);  // Mutator: Adds the account's last transaction globally
+    Account* openAccount(AccountId id, const std::string& name, const std::string& accountType,
+                         Money initialBalance, const std::string& credential,
+                         bool shardsLocked);                     // Mutator: Creates quietly under an allocated ID
+    static bool isSupportedAccountType(const std::string& accountType);  // Utility: "Checking" or "Savings"
+
+    // Password checks: the KDF runs on passwordVerifier between two short shard-lock holds
+    enum CredentialCheck { CREDENTIALS_VALID, CREDENTIALS_INVALID, ACCOUNT_MISSING, ACCOUNT_MARKED, LOGINS_THROTTLED };
+    CredentialCheck checkCredentials(AccountId id, const std::string& password,
+                                     bool& needsCleanup);        // Mutator: Checks a login, booking the attempt
+    void migratePasswords();                                     // Mutator: Hashes plaintext credentials and saves
+
+    // Shard helpers
+    AccountShard& shardFor(AccountId id) const;                  // Getter: Shard owning an account ID
+    std::vector<std::unique_lock<std::mutex> > lockAllShards() const;  // Locks every shard in order
+    std::vector<Account*> collectAccounts() const;               // Accessor: ID-ordered view (shards locked)
+    void addLoadedAccounts(std::vector<Account*>& loaded);       // Mutator: Indexes loaded accounts
 
 public:
     BankSystem(const std::string& accFile = "data/accounts.csv", 
-               const std::string& transFile = "data/transactions.csv");
+               const std::string& transFile = "data/transactions.csv",
+               const std::string& journalFile = "data/bank.journal",
+               const std::string& snapFile = "data/bank.snapshot",
+               size_t shardCount = 16,
+               uint32_t maxAccountNumber = AccountIdAllocator::DEFAULT_LAST,
+               unsigned passwordCost = PasswordHash::DEFAULT_COST);
     ~BankSystem();
 
     // Data I/O methods
-    void loadData();      // Mutator: Loads accounts and transactions from files
-    void saveData();      // Accessor: Saves accounts and transactions to files
+    void loadData();      // Mutator: Loads the snapshot (or CSV files) and replays the journal
+    void saveData();      // Mutator: Saves what changed since the last save (or everything, now and then)
 
     // Account management methods (Mutators)
     bool createAccount(const std::string& name, const std::string& accountType, 
-                      double initialBalance, const std::string& password);   // Creates a new account
+                      Money initialBalance, const std::string& password);    // Creates a new account
     bool closeAccount(const std::string& accountId, const std::string& password);  // Removes an account
     
     // Account retrieval methods (Accessors)
@@ -36,12 +168,62 @@ public:
     
     // Security methods
     void cleanupDeletedAccounts(); // Mutator: Removes accounts marked for deletion
+    void setLoginThrottle(uint32_t failuresPerSecond, uint32_t burst);  // Mutator: Bank-wide failed-login limit (0: off)
+    uint64_t getThrottledLogins() const;  // Getter: Login attempts the throttle turned away since start-up
     
     // Transaction methods (Mutators)
-    bool deposit(const std::string& accountId, double amount);  // Adds funds to account
-    bool withdraw(const std::string& accountId, double amount); // Removes funds from account
-    void applyInterestToAllSavingsAccounts();  // Applies interest to all savings accounts
+    bool deposit(const std::string& accountId, Money amount);   // Adds funds to account (false if it can't be journaled)
+    bool withdraw(const std::string& accountId, Money amount);  // Removes funds from account (false if it can't be journaled)
+
+    // Once a journal write fails, the operations it held are lost but already applied in memory,
+    // so the bank stops changing and saving anything; a restart recovers the last durable state
+    bool isReadOnly() const;           // Getter: Whether a journal write failed
+    void applyInterestToAllSavingsAccounts();  // Brings every savings account's accrued interest up to date
+
+    // Background persistence (Mutators). checkpoint() appends the changes since the last save to
+    // the files while other sessions keep running and folds the journal into them; the persister
+    // thread runs it every interval, after everyMutations journaled changes and/or once the
+    // journal reaches journalBytes (0 disables a trigger). The destructor stops the persister
+    // before the final save.
+    static const size_t CHECKPOINT_CHUNK = 4096;      // Ledger rows copied per lock hold
+    bool checkpoint();
+    void startPersister(std::chrono::seconds interval, uint64_t everyMutations, uint64_t journalBytes = 0);
+    void stopPersister();
+
+    // Checkpoint and journal figures since start-up
+    struct PersistenceStats {
+        uint64_t checkpoints;                 // Completed checkpoints
+        double lastCheckpointSeconds;
+        double totalCheckpointSeconds;
+        uint64_t foldedJournalBytes;          // Journal bytes checkpoints made redundant
+        Journal::ReplayStats startupReplay;   // What loadData() replayed
+        uint64_t journalSegment;              // Segment number of the current journal file
+        uint64_t journalBytes;                // Current journal size
+    };
+    PersistenceStats getPersistenceStats() const;   // Getter: Returns the checkpoint and replay figures
+
+    // Batch processing (Mutator): applies every operation, persists them with one journal sync
+    // and fills results (one per operation, capacity reused). Returns the number that succeeded.
+    // The batch holds every shard lock, so it is atomic with respect to other sessions. If the
+    // sync fails, nothing in the batch succeeded and the bank is read-only from then on.
+    size_t applyBatch(const std::vector<BatchOperation>& operations, std::vector<BatchResult>& results);
     
+    // Concurrency accessors
+    size_t getShardCount() const;      // Getter: Returns the number of account shards
+    size_t getAccountCount() const;    // Getter: Returns the number of open accounts
+    Money getTotalBalance() const;     // Getter: Sum of all booked balances (consistent across shards)
+    size_t getTransactionCount() const; // Getter: Returns the number of recorded transactions
+    Money getInterestPosted() const;   // Getter: Interest credited to savings accounts since start-up
+    void writeStats(std::ostream& out) const;  // Accessor: Per-operation latency table, then checkpoint/replay/throttle figures
+
+    // Statements (Accessor): transactions of an account (open or closed) with fromTime <= time <= toTime,
+    // oldest first, pageSize at a time. Start with an empty pageToken and pass back nextPageToken.
+    // Returns false for a malformed account ID or page token.
+    static const size_t STATEMENT_PAGE_SIZE = 50;
+    bool getStatement(const std::string& accountId, std::time_t fromTime, std::time_t toTime,
+                      const std::string& pageToken, StatementPage& page,
+                      size_t pageSize = STATEMENT_PAGE_SIZE) const;
+
     // Display and utility methods
     void displayAllAccounts();  // Accessor: Displays all accounts information
     void runPasswordCracker();  // Utility: Tests password strength
@@ -0,0 +1,26 @@
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include <string>
+#include "BankSystem.h"
+
+/**
+ * Streams an operations file through BankSystem::applyBatch.
+ *
+ * Input, one operation per line (blank lines and lines starting with '#' are skipped):
+ *   deposit,<accountId>,<amount>
+ *   withdraw,<accountId>,<amount>
+ *   create,,<initialBalance>,<name>,<Checking|Savings>,<password>
+ *   close,<accountId>,,,,<password>
+ *
+ * Output, one line per operation:
+ *   <line>,OK,<accountId>,<balance>
+ *   <line>,ERR,<accountId>,<reason>
+ *
+ * Returns false if a file can't be opened or the journal failed (every
+ * operation from the failed chunk on is reported as not applied).
+ */
+bool runBatchFile(BankSystem& bankSystem, const std::string& operationsFile,
+                  const std::string& resultsFile, size_t chunkSize = 65536);
+
+#endif // BATCH_PROCESSOR_H
@@ -0,0 +1,91 @@
+#ifndef TRANSACTION_LOG_H
+#define TRANSACTION_LOG_H
+
+#include <vector>
+#include <mutex>
+#include <ctime>
+#include <cstdint>
+#include "../System details/Transaction.h"
+
+/**
+ * Global, append-only list of transactions shared by every session.
+ * Appends from concurrent threads are serialized by a short critical
+ * section; bulk readers (persistence) get exclusive access to the
+ * underlying vector through access().
+ *
+ * A secondary index chains every account's transactions together: each row
+ * records the position of the account's next row, and the account keeps its
+ * first and last in a flat open-addressing table (as AccountIndex). Indexing
+ * a row is one probe and one 4-byte write, so loading a large ledger indexes
+ * it in a single cheap pass. Every SKIP_EVERY-th row of an account is also
+ * kept in a sorted list of its own (only accounts that long have one).
+ * Per-account appends happen under the account's shard lock, so each chain
+ * is in time order: a statement binary-searches that list for the last skip
+ * row before fromTime and walks fewer than SKIP_EVERY rows from there to its
+ * first row, then follows the chain (or resumes where the previous page
+ * stopped). The cost is O(log(account rows) + rows returned), never the
+ * whole log.
+ */
+class TransactionLog {
+public:
+    static const size_t NO_OFFSET = static_cast<size_t>(-1);
+    static const uint32_t SKIP_EVERY = 32;        // Account rows per skip row
+
+private:
+    // First and last row of one account's chain
+    struct Chain {
+        uint32_t key;         // AccountId value, AccountId::INVALID when the slot is empty
+        uint32_t first;
+        uint32_t last;
+        uint32_t length;      // Rows in the chain
+        uint32_t skips;       // Index into skipLists, UINT32_MAX until the account has a skip row
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Transaction> entries;
+    std::vector<Chain> chains;                    // Power-of-two capacity, linear probing
+    size_t chainCount;
+    std::vector<uint32_t> nextInAccount;          // Per row: the account's next row (UINT32_MAX at its last)
+    std::vector<std::vector<uint32_t> > skipLists; // Per long account: its rows SKIP_EVERY, 2 * SKIP_EVERY, ...
+    size_t indexedCount;                          // entries[0, indexedCount) are indexed
+
+    size_t home(uint32_t key) const;              // Slot a key's probe run starts at
+    const Chain* findChain(uint32_t key) const;   // Accessor: The account's chain, nullptr if it has none
+    uint32_t firstRowFrom(const Chain& chain, std::time_t fromTime) const;  // Accessor: First row at or after fromTime
+    void growChains();                            // Mutator: Doubles the table
+    void indexNewEntries();   // Indexes entries appended through access() (lock held)
+
+public:
+    TransactionLog();
+
+    // Mutator: Adds a transaction, returns its position in the log
+    size_t append(const Transaction& transaction);
+
+    // Accessor: Returns the number of transactions in the log
+    size_t size() const;
+
+    /**
+     * Accessor: Copies up to maxCount of the account's transactions with a time no later than
+     * toTime into out, starting at the row offset returned by an earlier call or, for NO_OFFSET,
+     * at its first one at or after fromTime. Returns the offset to resume from, or NO_OFFSET once
+     * done (also for an offset that isn't one of the account's rows).
+     */
+    size_t readAccount(AccountId accountId, std::time_t fromTime, std::time_t toTime,
+                       size_t offset, size_t maxCount, std::vector<Transaction>& out) const;
+
+    // Runs fn(std::vector<Transaction>&) while holding the log lock; fn may only append
+    template<typename Fn>
+    void access(Fn fn) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fn(entries);
+        indexNewEntries();
+    }
+
+    template<typename Fn>
+    void access(Fn fn) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        fn(entries);
+    }
+};
+
+#endif // TRANSACTION_LOG_H
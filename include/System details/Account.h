@@ -3,53 +3,97 @@
 
 #include <string>
 #include <queue>
-#include <stack>
 #include <iostream>
+#include <ctime>
+#include <cstdint>
 #include "Transaction.h"
+#include "TransactionId.h"
+#include "Money.h"
 
+class CsvWriter;
+
+/**
+ * Base of every account kind. The kind is a tag set by the constructor, and
+ * the kind-specific behaviour (checking fees, savings rate, CSV columns) is
+ * selected with a switch on it, so the hot paths (batches, sweeps, load and
+ * save) make no virtual calls and no type-string comparisons. The class has
+ * no vtable; AccountPool destroys accounts through the tag as well.
+ */
 class Account {
+public:
+    enum Kind : uint8_t {
+        BASIC    = 0,   // Any other type name read from the data files
+        CHECKING = 1,   // CheckingAccount: per-withdrawal fee
+        SAVINGS  = 2    // SavingsAccount: interest rate
+    };
+
+    // Login security: failures within FAILURE_WINDOW_SECONDS of each other count together
+    static const uint8_t LOCK_AFTER_FAILURES = 3;       // Locked for LOCKOUT_SECONDS from the third
+    static const uint8_t DELETE_AFTER_FAILURES = 5;     // Marked for deletion at the fifth
+    static const uint32_t LOCKOUT_SECONDS = 60;
+    static const uint32_t FAILURE_WINDOW_SECONDS = 3600;
+
 protected:
+    Kind kind;
     std::string accountId;
     std::string customerName;
     std::string accountType;
-    double balance;
+    Money balance;
     std::string password;
     std::queue<Transaction> recentTransactions;
-    std::stack<int> failedAttempts; // Stack to track failed login attempts
-    bool locked;                    // Flag to indicate if account is locked
-    int lockoutTime;                // Current lockout time in seconds
+    // Fixed-size login security state (Unix seconds): no allocation however many failures arrive
+    uint32_t failureTimes[DELETE_AFTER_FAILURES];  // Ring of the most recent failed login attempts
+    uint32_t lockedUntil;           // Logins are refused before this time (0: not locked)
+    uint8_t nextFailure;            // Ring slot the next failure goes to
+    uint8_t failureCount;           // Ring slots in use
+    bool markedForDeletion;         // Too many failures; cleanupDeletedAccounts() removes the account
+
+    uint8_t recentFailures(std::time_t now) const;  // Failures in the window ending at now
+
+    void rememberTransaction(const Transaction& trans);  // Keeps the last 10 in recentTransactions
+
+    // Used by the subclasses to tag themselves
+    Account(Kind kind, const std::string& id, const std::string& name, const std::string& type,
+            Money initialBalance, const std::string& pwd);
 
 public:
     Account(const std::string& id, const std::string& name, const std::string& type, 
-            double initialBalance, const std::string& pwd);
-    
-    virtual ~Account() = default;
+            Money initialBalance, const std::string& pwd);
 
     // Getters (Accessor methods)
+    Kind getKind() const { return kind; }   // Getter: Returns the account kind tag (no virtual call)
     std::string getAccountId() const;       // Getter: Returns the account's unique identifier
     std::string getCustomerName() const;    // Getter: Returns the account holder's name
-    std::string getAccountType() const;     // Getter: Returns the type of account (Checking, Savings, etc.)
-    double getBalance() const;              // Getter: Returns the current account balance
-    std::string getPassword() const;        // Getter: Returns the account password (for internal use only)
+    const std::string& getAccountType() const;  // Getter: Returns the type of account (Checking, Savings, etc.)
+    Money getBalance() const;               // Getter: Returns the current account balance
+    std::string getPassword() const;        // Getter: Returns the stored credential, normally a PasswordHash (internal use only)
     bool isLocked() const;                  // Getter: Returns whether the account is locked due to failed attempts
-    int getLockoutTime() const;             // Getter: Returns the remaining lockout time in seconds
+    int getLockoutTime() const;             // Getter: Returns the seconds left until the lock expires
     
     // Security methods
-    bool validatePassword(const std::string& pwd);
+    bool validatePassword(const std::string& pwd);   // beginLogin() + the hash check + finishLogin(), in one go
+    bool beginLogin();                               // Lock check before a check done elsewhere; false if locked
+    bool finishLogin(bool matched);                  // Books the outcome of that check; returns whether the login succeeded
+    void setPassword(const std::string& credential); // Setter: Replaces the stored credential (hashed by the caller)
     void recordFailedAttempt();
     void resetFailedAttempts();
     void checkLockStatus();
     bool shouldBeDeleted() const; // Check if account should be deleted due to security
 
-    // Account operations (Mutator methods)
-    virtual bool deposit(double amount);     // Setter: Adds funds to account and updates balance
-    virtual bool withdraw(double amount);    // Setter: Removes funds from account and updates balance
+    // Getter: Returns the most recent deposit/withdrawal (only valid after one succeeded)
+    const Transaction& getLastTransaction() const;
 
-    // For CSV saving
-    virtual std::string toCSV() const;
+    // Recovery (Mutator method)
+    void restoreBalance(Money newBalance);   // Setter: Overwrites the balance when replaying the journal
+
+    // Account operations (Mutator methods)
+    bool deposit(Money amount);              // Setter: Adds funds to account and updates balance
+    bool withdraw(Money amount);             // Setter: Removes funds (plus the fee for checking accounts)
+    bool postDeposit(const Transaction& trans);  // Setter: Credits a deposit built by the caller (bulk postings)
 
-private:
-    std::string generateTransactionId() const;
+    // For CSV saving (checking accounts add their fee column, savings accounts their rate and accrual columns)
+    void writeCSV(CsvWriter& out) const;     // Writes the row (no newline) into out
+    std::string toCSV() const;
 };
 
 #endif // ACCOUNT_H
\ No newline at end of file
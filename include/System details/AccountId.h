@@ -0,0 +1,39 @@
+#ifndef ACCOUNT_ID_H
+#define ACCOUNT_ID_H
+
+#include <string>
+#include <cstdint>
+
+/**
+ * Packed numeric form of an account ID.
+ * "ACC12345" is stored as the 32-bit integer 12345, so lookups hash and
+ * compare a single word instead of a heap-allocated string.
+ * The text form is "ACC" followed by the number zero-padded to 5 digits.
+ */
+class AccountId {
+private:
+    uint32_t value;
+
+public:
+    static const uint32_t INVALID = 0xFFFFFFFFu;
+    static const uint32_t MAX_VALUE = 999999999u;   // "ACC" + at most 9 digits
+    static const size_t MAX_TEXT_LENGTH = 13;       // Room for any 32-bit value
+
+    AccountId() : value(INVALID) {}
+    explicit AccountId(uint32_t number) : value(number) {}
+
+    // Parses the canonical text form; returns an invalid ID for anything else
+    static AccountId fromString(const std::string& text);
+    static AccountId fromString(const char* text, size_t length);
+
+    size_t format(char* out) const; // Accessor: Writes the text form (at most MAX_TEXT_LENGTH chars)
+    std::string toString() const;   // Accessor: Returns the "ACC#####" text form
+    uint32_t getValue() const { return value; }
+    bool isValid() const { return value != INVALID; }
+
+    bool operator==(const AccountId& other) const { return value == other.value; }
+    bool operator!=(const AccountId& other) const { return value != other.value; }
+    bool operator<(const AccountId& other) const { return value < other.value; }
+};
+
+#endif // ACCOUNT_ID_H
@@ -5,14 +5,15 @@
 
 class CheckingAccount : public Account {
 private:
-    double transactionFee;
+    Money transactionFee;
 
 public:
-    CheckingAccount(const std::string& id, const std::string& name, double initialBalance, 
-                    const std::string& pwd, double fee = 1.0);
+    static const int64_t DEFAULT_FEE_CENTS = 100;
 
-    bool withdraw(double amount) override;  // Mutator: Withdraws funds with transaction fee
-    std::string toCSV() const override;   // Accessor: Returns account data in CSV format
+    CheckingAccount(const std::string& id, const std::string& name, Money initialBalance, 
+                    const std::string& pwd, Money fee = Money::fromCents(DEFAULT_FEE_CENTS));
+
+    Money getTransactionFee() const;        // Getter: Returns the fee charged per withdrawal (added by Account::withdraw)
 };
 
 #endif // CHECKING_ACCOUNT_H
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+// How parsed amounts with more decimals than the type keeps are rounded
+enum RoundingMode {
+    ROUND_HALF_EVEN,   // Banker's rounding: ties go to the even neighbour (the default)
+    ROUND_HALF_UP,     // Ties go away from zero
+    ROUND_DOWN         // Truncate toward zero
+};
+
+/**
+ * Exact monetary amount stored as a signed 64-bit count of cents.
+ * Arithmetic is checked: + and - throw std::overflow_error instead of
+ * wrapping, and tryAdd/trySubtract report overflow without throwing.
+ * Text is parsed and formatted with integer code only ("-1234.56").
+ */
+class Money {
+private:
+    int64_t cents;
+
+    explicit Money(int64_t minorUnits) : cents(minorUnits) {}
+
+public:
+    static const int DECIMALS = 2;
+    static const size_t MAX_TEXT_LENGTH = 24;      // Sign, 19 digits, point
+
+    Money() : cents(0) {}
+    static Money fromCents(int64_t cents) { return Money(cents); }
+    static Money fromDouble(double amount);       // Nearest cent; for data written by older versions
+
+    // Parses "123", "123.4", "-0.05"...; extra decimals are rounded with mode, false if malformed
+    static bool parse(const char* text, size_t length, Money& amount, RoundingMode mode = ROUND_HALF_EVEN);
+    static bool parse(const std::string& text, Money& amount, RoundingMode mode = ROUND_HALF_EVEN);
+
+    int64_t getCents() const { return cents; }
+    double toDouble() const { return static_cast<double>(cents) / 100.0; }  // Reporting only
+    bool isPositive() const { return cents > 0; }
+    bool isNegative() const { return cents < 0; }
+    bool isZero() const { return cents == 0; }
+
+    size_t format(char* out) const;               // Accessor: Writes "-1234.56" (at most MAX_TEXT_LENGTH chars)
+    std::string toString() const;                 // Accessor: Returns the text form
+
+    // Checked arithmetic
+    bool tryAdd(Money other, Money& result) const;
+    bool trySubtract(Money other, Money& result) const;
+    Money operator+(Money other) const;
+    Money operator-(Money other) const;
+    Money& operator+=(Money other);
+    Money& operator-=(Money other);
+
+    bool operator==(Money other) const { return cents == other.cents; }
+    bool operator!=(Money other) const { return cents != other.cents; }
+    bool operator<(Money other) const { return cents < other.cents; }
+    bool operator<=(Money other) const { return cents <= other.cents; }
+    bool operator>(Money other) const { return cents > other.cents; }
+    bool operator>=(Money other) const { return cents >= other.cents; }
+};
+
+// Writes the text form (honours the stream width, e.g. std::setw)
+std::ostream& operator<<(std::ostream& out, Money amount);
+
+/**
+ * Annual interest rate as an integer count of millionths (0.02 = 2% a year
+ * = 20000), the precision the account files store rates with. Savings
+ * accounts compound it daily; interest is truncated to the cent and the
+ * remainder carried to the next accrual (see SavingsAccount), so no rounding
+ * mode applies to it.
+ */
+class InterestRate {
+private:
+    int64_t micros;
+
+    explicit InterestRate(int64_t millionths) : micros(millionths) {}
+
+public:
+    static const int DECIMALS = 6;
+    static const int64_t SCALE = 1000000;
+    static const size_t MAX_TEXT_LENGTH = 24;      // Sign, 19 digits, point
+
+    InterestRate() : micros(0) {}
+    static InterestRate fromMicros(int64_t micros) { return InterestRate(micros); }
+    static InterestRate fromDouble(double rate);   // Nearest millionth; for data written by older versions
+
+    static bool parse(const char* text, size_t length, InterestRate& rate);
+
+    int64_t getMicros() const { return micros; }
+    double toDouble() const { return static_cast<double>(micros) / SCALE; }
+
+    size_t format(char* out) const;                // Accessor: Writes "0.020000"
+    std::string toString() const;
+};
+
+#endif // MONEY_H
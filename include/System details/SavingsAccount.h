@@ -1,18 +1,55 @@
 #ifndef SAVINGS_ACCOUNT_H
 #define SAVINGS_ACCOUNT_H
 
+#include <ctime>
 #include "Account.h"
 
+/**
+ * Savings account earning its annual interest rate compounded daily.
+ *
+ * Interest is accrued lazily: the account remembers the time it has accrued
+ * up to, and accrueInterest() credits the whole days elapsed since then in
+ * one step whenever the bank reads, changes or saves the account. Interest
+ * below one cent is carried (in millionths of a cent) to the next accrual,
+ * so frequent accruals on small balances lose nothing to rounding.
+ */
 class SavingsAccount : public Account {
 private:
-    double interestRate;
+    InterestRate interestRate;
+    std::time_t accruedThrough;     // Interest is booked up to this time (advances in whole days)
+    int64_t accrualCarry;           // Accrued interest not yet posted, in millionths of a cent
 
 public:
-    SavingsAccount(const std::string& id, const std::string& name, double initialBalance, 
-                   const std::string& pwd, double rate = 0.02);
+    static const int64_t DEFAULT_RATE_MICROS = 20000;   // 2% a year
+    static const int64_t SECONDS_PER_DAY = 86400;
+    static const int64_t DAYS_PER_YEAR = 365;
+    static const int64_t GROWTH_SCALE = 1000000000000;  // Growth factors are in 10^-12
+    static const int64_t CARRY_SCALE = 1000000;         // Carry units per cent
 
-    void applyInterest();                  // Mutator: Applies interest rate to account balance
-    std::string toCSV() const override;    // Accessor: Returns account data in CSV format
+    // accruedThrough defaults to now (a new account starts earning from its creation)
+    SavingsAccount(const std::string& id, const std::string& name, Money initialBalance,
+                   const std::string& pwd, InterestRate rate = InterestRate::fromMicros(DEFAULT_RATE_MICROS),
+                   std::time_t accruedThrough = 0, int64_t accrualCarry = 0);
+
+    InterestRate getInterestRate() const;  // Getter: Returns the annual interest rate
+    std::time_t getAccruedThrough() const; // Getter: Returns the time interest is booked up to
+    int64_t getAccrualCarry() const;       // Getter: Returns the unposted sub-cent interest
+    int64_t accrualDays(std::time_t now) const;  // Getter: Whole days not yet accrued at now
+
+    // Recovery (Mutator): Overwrites the accrual state when replaying the journal
+    void restoreAccrual(std::time_t accruedThrough, int64_t accrualCarry);
+
+    // Mutator: Accrues the whole days elapsed up to now and posts the interest that reached a
+    // full cent as a deposit stamped with the new accrual time. interest receives the posted
+    // amount (possibly zero). Returns false if no full day has elapsed (nothing changed).
+    bool accrueInterest(std::time_t now, Money& interest);
+
+    // Mutator: Books an accrual computed elsewhere (InterestEngine): advances by days, keeps
+    // carry and posts interestCents if positive. interest receives the posted amount.
+    void settleAccrual(int64_t days, int64_t interestCents, int64_t carry, Money& interest);
+
+    // Utility: (1 + rate / 365)^days - 1 in units of 1/GROWTH_SCALE (saturates near 18x growth)
+    static int64_t growthFor(InterestRate rate, int64_t days);
 };
 
-#endif // SAVINGS_ACCOUNT_H
\ No newline at end of file
+#endif // SAVINGS_ACCOUNT_H
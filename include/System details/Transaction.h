@@ -2,28 +2,56 @@
 #define TRANSACTION_H
 
 #include <string>
+#include <cstdint>
+#include <ctime>
+#include "AccountId.h"
+#include "TransactionId.h"
+#include "Money.h"
 
+class CsvWriter;
+
+/**
+ * One deposit or withdrawal, stored as a 32-byte trivially copyable record:
+ * integer IDs, an enum type, the amount in cents and an epoch timestamp.
+ * Text (IDs, "deposit"/"withdrawal", the ctime()-style date) is produced only
+ * when a transaction is rendered or exported.
+ */
 class Transaction {
+public:
+    enum Type : uint8_t {
+        DEPOSIT    = 0,
+        WITHDRAWAL = 1
+    };
+
+    static const size_t MAX_CSV_LENGTH = 128;      // Upper bound of formatCSV() output
+
 private:
-    std::string transactionId;
-    std::string accountId;
-    std::string type; // deposit, withdrawal
-    double amount;
-    std::string date;
+    uint64_t transactionId;
+    int64_t amountCents;    // Money::getCents()
+    int64_t timestamp;      // Seconds since the Unix epoch
+    uint32_t accountId;
+    Type type;
 
 public:
-    Transaction(const std::string& id, const std::string& accId, const std::string& transType, 
-                double amt, const std::string& transDate);
+    Transaction();
+    Transaction(TransactionId id, AccountId accId, Type transType, Money amt, std::time_t time);
 
     // Getters (Accessor methods)
-    std::string getTransactionId() const;  // Getter: Returns unique transaction identifier
-    std::string getAccountId() const;      // Getter: Returns the account ID associated with this transaction
-    std::string getType() const;           // Getter: Returns transaction type (deposit, withdrawal)
-    double getAmount() const;              // Getter: Returns the transaction amount
-    std::string getDate() const;           // Getter: Returns the date when transaction occurred
+    TransactionId getTransactionId() const; // Getter: Returns unique transaction identifier
+    AccountId getAccountId() const;         // Getter: Returns the account ID associated with this transaction
+    Type getType() const;                   // Getter: Returns transaction type (deposit, withdrawal)
+    const char* getTypeName() const;        // Getter: Returns "deposit" or "withdrawal"
+    Money getAmount() const;                // Getter: Returns the transaction amount
+    std::time_t getTimestamp() const;       // Getter: Returns when the transaction occurred
+    std::string getDate() const;            // Getter: Returns the timestamp formatted like ctime()
 
     // For CSV saving
     std::string toCSV() const;
+    size_t formatCSV(char* out) const;      // Writes the CSV line (no newline) into out, returns its length
+    void writeCSV(CsvWriter& out) const;    // Writes the CSV line (no newline) into out
+
+    // Parses "deposit" / "withdrawal"
+    static bool parseType(const char* text, size_t length, Type& type);
 };
 
-#endif // TRANSACTION_H
\ No newline at end of file
+#endif // TRANSACTION_H
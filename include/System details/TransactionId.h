@@ -0,0 +1,50 @@
+#ifndef TRANSACTION_ID_H
+#define TRANSACTION_ID_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 64-bit transaction identifier, generated Snowflake-style:
+ *
+ *   [41 bits: milliseconds since 2024-01-01 UTC][10 bits: generator slot][12 bits: sequence]
+ *
+ * Every thread owns a generator slot, so generate() needs no lock, no
+ * allocation and no random device, and two threads can never produce the
+ * same ID. The text form is "TXN" followed by 13 Crockford base-32 digits;
+ * it has a fixed width, so text order matches numeric (creation) order.
+ *
+ * Generated IDs never set the top bit. IDs written by older versions ("TXN"
+ * + up to 11 random [0-9A-Z] characters) are kept in that half instead:
+ *
+ *   [1][6 bits: character count][57 bits: characters as a base-36 number]
+ */
+class TransactionId {
+private:
+    uint64_t value;
+
+public:
+    static const size_t MAX_TEXT_LENGTH = 16;   // "TXN" + 13 digits
+
+    TransactionId() : value(0) {}
+    explicit TransactionId(uint64_t raw) : value(raw) {}
+
+    static TransactionId generate();            // Returns a new, process-wide unique ID
+
+    // Parses the text form; returns an invalid ID for anything else (e.g. legacy random IDs)
+    static TransactionId fromString(const std::string& text);
+    static TransactionId fromString(const char* text, size_t length);
+
+    size_t format(char* out) const;             // Accessor: Writes the text form (at most MAX_TEXT_LENGTH chars)
+    std::string toString() const;               // Accessor: Returns the text form
+    uint64_t getValue() const { return value; }
+    bool isValid() const { return value != 0; }
+    bool isLegacy() const { return (value >> 63) != 0; }
+
+    bool operator==(const TransactionId& other) const { return value == other.value; }
+    bool operator!=(const TransactionId& other) const { return value != other.value; }
+    bool operator<(const TransactionId& other) const { return value < other.value; }
+};
+
+#endif // TRANSACTION_ID_H
@@ -0,0 +1,46 @@
+#ifndef ACCOUNT_ID_ALLOCATOR_H
+#define ACCOUNT_ID_ALLOCATOR_H
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "../System details/AccountId.h"
+
+/**
+ * Hands out unused account numbers from a configurable range [first, last].
+ *
+ * One bit per number records whether it is taken, and a cursor remembers the
+ * first 64-bit word that still has a free bit, so allocation costs the same
+ * however many accounts exist. Numbers are never released: the transaction
+ * history of a closed account still refers to its ID.
+ */
+class AccountIdAllocator {
+public:
+    static const uint32_t DEFAULT_FIRST = 10000;     // ACC10000
+    static const uint32_t DEFAULT_LAST = 9999999;    // ACC9999999 (10M IDs, 1.2 MB of bitmap)
+
+private:
+    uint32_t first;
+    uint32_t last;
+    std::vector<uint64_t> words;   // Bit set = number in use
+    size_t cursor;                 // Every word before it is full
+    size_t used;
+    mutable std::mutex mutex;
+
+    AccountId allocateLocked();
+
+public:
+    AccountIdAllocator(uint32_t first = DEFAULT_FIRST, uint32_t last = DEFAULT_LAST);
+
+    void markUsed(AccountId id);                                // Mutator: Reserves an existing ID (outside the range: ignored)
+    AccountId allocate();                                       // Mutator: Returns a free ID, invalid once exhausted
+    size_t allocate(size_t count, std::vector<AccountId>& ids); // Mutator: Appends up to count IDs, returns how many
+
+    uint32_t getFirst() const;       // Getter: Lowest number handed out
+    uint32_t getLast() const;        // Getter: Highest number handed out
+    size_t getUsedCount() const;     // Getter: Numbers taken within the range
+    size_t getCapacity() const;      // Getter: Size of the range
+};
+
+#endif // ACCOUNT_ID_ALLOCATOR_H
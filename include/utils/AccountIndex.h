@@ -0,0 +1,69 @@
+#ifndef ACCOUNT_INDEX_H
+#define ACCOUNT_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../System details/AccountId.h"
+
+class Account;
+
+/**
+ * Flat open-addressing hash index from AccountId to Account*.
+ *
+ * Slots live in one contiguous array (power-of-two capacity, linear probing),
+ * so a lookup is a multiply, a mask and usually a single cache line, instead
+ * of a red-black tree walk with string compares. Deletion shifts the following
+ * probe run back, so no tombstones accumulate.
+ */
+class AccountIndex {
+private:
+    struct Slot {
+        uint32_t key;        // AccountId value, AccountId::INVALID when empty
+        Account* account;
+    };
+
+    std::vector<Slot> slots;
+    size_t count;
+    size_t mask;
+
+    size_t home(uint32_t key) const;
+    void grow();
+
+public:
+    AccountIndex();
+
+    Account* find(AccountId id) const;                 // Accessor: Returns the account or nullptr
+    bool contains(AccountId id) const;                 // Accessor: Returns whether the ID is indexed
+    bool insert(AccountId id, Account* account);       // Mutator: Adds an entry, false if the ID exists
+    Account* replace(AccountId id, Account* account);  // Mutator: Inserts or overwrites, returns the old value
+    bool erase(AccountId id);                          // Mutator: Removes an entry, false if missing
+    void clear();                                      // Mutator: Removes every entry
+    void reserve(size_t entries);                      // Mutator: Pre-sizes for entries without rehashing
+
+    size_t size() const;                               // Getter: Returns the number of entries
+    bool empty() const;                                // Getter: Returns whether the index is empty
+
+    // Visits every entry in slot (unordered) order: fn(AccountId, Account*)
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        for (const Slot& slot : slots) {
+            if (slot.key != AccountId::INVALID) fn(AccountId(slot.key), slot.account);
+        }
+    }
+
+    // Removes every entry for which fn(AccountId, Account*) returns true
+    template<typename Fn>
+    size_t eraseIf(Fn fn) {
+        std::vector<uint32_t> doomed;
+        forEach([&](AccountId id, Account* account) {
+            if (fn(id, account)) doomed.push_back(id.getValue());
+        });
+        for (uint32_t key : doomed) {
+            erase(AccountId(key));
+        }
+        return doomed.size();
+    }
+};
+
+#endif // ACCOUNT_INDEX_H
@@ -0,0 +1,81 @@
+#ifndef ACCOUNT_POOL_H
+#define ACCOUNT_POOL_H
+
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "../System details/Account.h"
+#include "../System details/CheckingAccount.h"
+#include "../System details/SavingsAccount.h"
+
+/**
+ * Slab allocator for Account objects of every kind.
+ *
+ * Accounts are constructed in place in fixed-size slots carved out of large
+ * slabs, so millions of accounts sit next to each other instead of being
+ * scattered across the heap. A pointer returned by create() is a stable
+ * handle: slabs never move, and the slot is only reused after destroy(), which
+ * puts it on a free list for the next create(). clear() (and the destructor)
+ * destroys every live account slab by slab and frees the slabs in bulk.
+ * All members are thread-safe.
+ */
+class AccountPool {
+public:
+    static const size_t SLOTS_PER_SLAB = 4096;
+
+private:
+    template<size_t A, size_t B>
+    struct MaxOf {
+        static const size_t value = A > B ? A : B;
+    };
+
+    // Large enough for any account kind
+    static const size_t OBJECT_SIZE =
+        MaxOf<sizeof(Account), MaxOf<sizeof(CheckingAccount), sizeof(SavingsAccount)>::value>::value;
+
+    struct Slot {
+        alignas(std::max_align_t) unsigned char storage[OBJECT_SIZE];   // Must stay first (see slotOf)
+        bool live;
+    };
+
+    std::vector<std::unique_ptr<Slot[]> > slabs;
+    std::vector<Slot*> freeSlots;   // Destroyed slots, reused most recent first
+    size_t used;                    // Slots handed out from the last slab so far
+    size_t liveCount;
+    mutable std::mutex mutex;
+
+    Slot* acquireSlot();            // Caller holds mutex
+    static Slot* slotOf(Account* account);
+    static void destruct(Account* account);   // Runs the destructor of the account's kind
+
+public:
+    AccountPool();
+    ~AccountPool();
+
+    AccountPool(const AccountPool&) = delete;
+    AccountPool& operator=(const AccountPool&) = delete;
+
+    // Mutator: Constructs an account of kind T (Account or a subclass) in a pooled slot
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(sizeof(T) <= OBJECT_SIZE, "account kind does not fit in a pool slot");
+        std::lock_guard<std::mutex> lock(mutex);
+        Slot* slot = acquireSlot();
+        T* account = new (slot->storage) T(std::forward<Args>(args)...);
+        slot->live = true;
+        ++liveCount;
+        return account;
+    }
+
+    void destroy(Account* account);    // Mutator: Destroys a pooled account and frees its slot (nullptr: no-op)
+    void clear();                      // Mutator: Destroys every account and releases all slabs
+
+    size_t size() const;               // Getter: Returns the number of live accounts
+    size_t capacity() const;           // Getter: Returns the number of slots in all slabs
+};
+
+#endif // ACCOUNT_POOL_H
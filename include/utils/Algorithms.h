@@ -4,13 +4,15 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
 
 // Algorithm 1: Binary search for account existence
 template<typename KeyType, typename ValueType>
 bool binarySearchMap(const std::map<KeyType, ValueType>& mapToSearch, const KeyType& key);
 
-// Algorithm 2: Generate unique account ID
-std::string generateUniqueAccountId(const std::map<std::string, void*>& existingAccounts);
+// Algorithm 2: Unique account IDs are handed out by AccountIdAllocator (AccountIdAllocator.h)
 
 // Algorithm 3: Password strength checker using stacks
 int checkPasswordStrength(const std::string& password);
@@ -21,4 +23,42 @@ std::string simulatePasswordCrack(const std::string& password);
 // Helper function: Split string by delimiter (for CSV parsing)
 std::vector<std::string> splitString(const std::string& str, char delimiter);
 
+// Non-owning view of one CSV field inside a larger buffer (e.g. a mapped file)
+struct FieldView {
+    const char* data;
+    size_t size;
+
+    std::string str() const { return std::string(data, size); }
+    bool equals(const char* text) const {
+        return std::strlen(text) == size && std::memcmp(data, text, size) == 0;
+    }
+};
+
+// Helper function: Split [begin, end) in place into at most maxFields views, returns the field count
+size_t splitFields(const char* begin, const char* end, char delimiter, FieldView* fields, size_t maxFields);
+
+// Helper function: Thread-safe std::ctime() replacement (same format, no trailing newline)
+std::string formatDate(std::time_t time);
+
+// Length of the ctime()-style date text, e.g. "Fri Oct 16 21:16:01 2026"
+const size_t DATE_TEXT_LENGTH = 24;
+
+// Helper function: Writes the date text for time into out (DATE_TEXT_LENGTH chars), returns its length
+size_t formatDate(std::time_t time, char* out);
+
+// Helper function: Parses ctime()-style local date text back into a timestamp, false if malformed
+bool parseDate(const char* str, size_t length, std::time_t& time);
+
+// Helper function: CRC-32 checksum used by the journal and snapshot files
+uint32_t crc32(const char* data, size_t length);
+
+// Helper function: Replaces path with contents via a synced temp file + rename, false on failure
+bool writeFileAtomically(const std::string& path, const std::string& contents);
+
+// Helper function: Appends data to path (created if missing) and fsyncs it, false on failure
+bool appendFileSynced(const std::string& path, const char* data, size_t size);
+
+// Helper function: Makes renames/creations of entries in path's directory durable, false on failure
+bool syncParentDirectory(const std::string& path);
+
 #endif // ALGORITHMS_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Buffered sink for the CSV files. Rows are formatted straight into one
+ * reusable buffer (numbers, IDs and money with the integer formatters, no
+ * temporary strings) and the buffer goes to the file with a single write()
+ * each time it fills, instead of an allocation per field and a flush per row.
+ *
+ * open() writes a replacement that commit() syncs and renames over the file;
+ * openForAppend() appends and commit() syncs. A writer that was never opened
+ * keeps the text in memory (see str()), which is how toCSV() builds one row.
+ */
+class CsvWriter {
+public:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+private:
+    std::vector<char> buffer;
+    size_t used;                     // Bytes of buffer holding unwritten text
+    int fd;
+    bool replacing;                  // open(): writing path + ".tmp"
+    bool failed;                     // A write failed; commit() reports it
+    std::string path;
+
+    void makeRoom(size_t size);      // Flushes (or, in memory, grows) so size bytes fit
+    void flush();                    // Mutator: Writes the buffer to the file
+
+public:
+    CsvWriter();
+    ~CsvWriter();                    // An uncommitted replacement is discarded (the file is untouched)
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    bool open(const std::string& filePath);            // Mutator: Starts a replacement of the file
+    bool openForAppend(const std::string& filePath);   // Mutator: Appends to the file (created if missing)
+    bool commit();                   // Mutator: Writes the rest and syncs (and renames); false if anything failed
+
+    char* reserve(size_t size) {     // Mutator: Room for size bytes; keep what was written with advance()
+        if (used + size > buffer.size()) makeRoom(size);
+        return buffer.data() + used;
+    }
+    void advance(size_t size) { used += size; }
+
+    void put(char c) { *reserve(1) = c; ++used; }
+    void put(const char* data, size_t size);           // Mutator: Appends raw text
+    void put(const std::string& text) { put(text.data(), text.size()); }
+    void putInteger(int64_t value);                    // Mutator: Appends the decimal digits of value
+
+    // Appends a value with a format(char*) member and a MAX_TEXT_LENGTH bound (Money, AccountId, ...)
+    template<typename T>
+    void putFormatted(const T& value) {
+        size_t bound = T::MAX_TEXT_LENGTH;
+        char* out = reserve(bound);
+        advance(value.format(out));
+    }
+
+    void endRow() { put('\n'); }
+
+    std::string str() const;         // Getter: Returns the buffered text (the whole row for an unopened writer)
+};
+
+#endif // CSV_WRITER_H
@@ -3,26 +3,93 @@
 
 #include <string>
 #include <vector>
-#include <map>
 #include "../System details/Account.h"
 #include "../System details/Transaction.h"
+#include "../System details/AccountId.h"
+#include "AccountPool.h"
 
 class FileHandler {
+public:
+    // Throughput of the most recent loadTransactions call
+    struct LoadStats {
+        size_t rows;
+        unsigned threads;
+        double seconds;
+
+        LoadStats() : rows(0), threads(0), seconds(0.0) {}
+        double rowsPerSecond() const { return seconds > 0.0 ? rows / seconds : 0.0; }
+    };
+
+    // Where the transactions file ended when the accounts file was last written in full,
+    // and the journal segment the snapshot written with it covers
+    struct ChangeBase {
+        size_t transactionRows;
+        uint64_t transactionBytes;
+        uint64_t journalSegment;
+
+        ChangeBase() : transactionRows(0), transactionBytes(0), journalSegment(0) {}
+    };
+
+    // Files smaller than this are parsed on the calling thread in auto mode
+    static const size_t PARALLEL_LOAD_MIN_BYTES = 8 * 1024 * 1024;
+
 private:
     std::string accountsFilePath;
     std::string transactionsFilePath;
+    unsigned loadThreads;        // 0 = pick automatically from file size and core count
+    LoadStats lastLoadStats;
+    size_t accountChangeRows;    // Rows in the account change segment
+
+    // Zero-copy loaders over a memory-mapped file; return false if the file can't be mapped
+    bool loadAccountsMapped(std::vector<Account*>& accounts, AccountPool& pool);
+    bool loadTransactionsMapped(std::vector<Transaction>& transactions);
+
+    // Parallel load: newline-aligned chunks parsed on a thread each, merged in file order
+    static void loadTransactionsParallel(const char* data, size_t size, unsigned threads,
+                                         std::vector<Transaction>& transactions);
+    static void parseTransactionChunk(const char* begin, const char* end,
+                                      std::vector<Transaction>& transactions);
+
+    // Line-by-line std::getline loaders, used when mapping is unavailable
+    void loadAccountsStream(std::vector<Account*>& accounts, AccountPool& pool);
+    void loadTransactionsStream(std::vector<Transaction>& transactions);
 
 public:
     FileHandler(const std::string& accFile = "data/accounts.csv", 
               const std::string& transFile = "data/transactions.csv");
 
-    // Load data from CSV files
-    void loadAccounts(std::map<std::string, Account*>& accounts);
+    // Load tuning (Mutator) and load statistics (Accessor)
+    void setLoadThreads(unsigned threads);   // 0 = auto, 1 = single-threaded, N = N parser threads
+    LoadStats getLastLoadStats() const;
+
+    // Load data from CSV files (accounts are created in pool and appended in file order)
+    void loadAccounts(std::vector<Account*>& accounts, AccountPool& pool);
     void loadTransactions(std::vector<Transaction>& transactions);
 
-    // Save data to CSV files
-    void saveAccounts(const std::map<std::string, Account*>& accounts);
+    // Save data to CSV files (accounts are written in the given order); false on failure.
+    // Rows stream through a CsvWriter, and whole files are replaced atomically.
+    bool saveAccounts(const std::vector<Account*>& accounts);
     void saveTransactions(const std::vector<Transaction>& transactions);
+    bool appendTransactions(const std::vector<Transaction>& transactions, size_t first);  // Synced
+
+    // Incremental account saves. Between full saves, the accounts changed since are appended to
+    // a change segment next to the accounts file (its path + ".delta"): a full CSV row per
+    // changed account and a "-ID" row per closed one; the last row for an ID wins. Its first
+    // row, "#base,<rows>,<bytes>,<segment>", is the ChangeBase of the accounts file it continues.
+    // A checkpoint follows its rows with "#covers,<segment>": the journal up to that segment is
+    // in the files from then on.
+    ChangeBase getChangeBase(size_t transactionRows, uint64_t journalSegment) const;  // Getter: Base at the current end of the transactions file
+    bool startAccountChanges(const ChangeBase& base);   // Mutator: Empties the segment (after a full save)
+    bool appendAccountChanges(const std::vector<const Account*>& changed, const std::vector<AccountId>& closed,
+                              uint64_t coveredSegment = 0);  // Mutator: Appends and syncs rows (and a covers row)
+    size_t getAccountChangeCount() const;               // Getter: Rows in the segment
+    std::string getAccountChangesPath() const;          // Getter: Path of the segment
+
+    // Reads the segment: its account rows are appended to accounts (to be applied in order),
+    // the closed IDs to closed and the newest journal segment it covers (at least the base's)
+    // to coveredSegment. False if there is no segment.
+    bool loadAccountChanges(std::vector<Account*>& accounts, std::vector<AccountId>& closed,
+                            AccountPool& pool, ChangeBase& base, uint64_t& coveredSegment);
 };
 
 #endif // FILE_HANDLER_H
\ No newline at end of file
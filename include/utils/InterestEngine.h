@@ -0,0 +1,67 @@
+#ifndef INTEREST_ENGINE_H
+#define INTEREST_ENGINE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include "../System details/SavingsAccount.h"
+#include "../System details/Transaction.h"
+
+/**
+ * Bulk interest accrual over many savings accounts (saves and full sweeps).
+ *
+ * add() gathers each account that has whole days to accrue at asOf: its
+ * balance (cents), daily-compounded growth for those days and sub-cent carry
+ * go into plain parallel arrays. run() computes every accrual with a
+ * branch-free integer kernel over those arrays, then books them on the
+ * accounts, splitting both passes across worker threads (a pool kept for the
+ * life of the process), and returns the accruals in gather order so the
+ * caller can append them to the ledger in one go. Results are identical to
+ * SavingsAccount::accrueInterest().
+ */
+class InterestEngine {
+public:
+    // Fewer accounts than this are swept on the calling thread in auto mode
+    static const size_t PARALLEL_MIN_ACCOUNTS = 65536;
+
+    // One account whose accrual run() brought up to date
+    struct Accrual {
+        SavingsAccount* account;
+        Money interest;                      // Posted amount (zero if it all went to the carry)
+    };
+
+private:
+    std::time_t asOf;
+    std::vector<SavingsAccount*> accounts;
+    std::vector<int64_t> days;               // Whole days to accrue
+    std::vector<int64_t> balanceCents;
+    std::vector<int64_t> growth;             // SavingsAccount::growthFor(rate, days); 0 without a positive balance
+    std::vector<int64_t> carry;              // In: the account's carry; out: the new carry
+    std::vector<int64_t> interestCents;
+    std::vector<SavingsAccount*> wideAccounts;   // Balance * growth overflows 64 bits: done by the account itself
+    unsigned threads;                        // 0 = pick automatically from the account count
+
+    // Accounts mostly share a rate and an accrual day, so one cached growth covers most of them
+    int64_t cachedRateMicros;
+    int64_t cachedDays;
+    int64_t cachedGrowth;
+
+public:
+    explicit InterestEngine(std::time_t asOf, unsigned threads = 0);
+
+    void reserve(size_t count);              // Mutator: Pre-sizes the arrays
+    void add(SavingsAccount* account);       // Mutator: Gathers one account (skipped if already up to date)
+    void clear();                            // Mutator: Forgets the gathered accounts (keeps capacity)
+    size_t size() const;                     // Getter: Returns the number of gathered accounts
+
+    // Mutator: Accrues every gathered account up to asOf and appends one entry per account to accruals
+    void run(std::vector<Accrual>& accruals);
+
+    // Kernel: total = balance[i] * growth[i] / 10^6 + carry[i]; interest[i] = total / 10^6 and
+    // carry[i] = the remainder. Every product must fit in 64 bits
+    static void computeAccrual(const int64_t* balanceCents, const int64_t* growth,
+                               int64_t* carry, int64_t* interestCents, size_t count);
+};
+
+#endif // INTEREST_ENGINE_H
@@ -0,0 +1,125 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "../System details/TransactionId.h"
+#include "../System details/Money.h"
+
+/**
+ * Append-only write-ahead journal for BankSystem mutations.
+ *
+ * Every record is framed as [length][crc32][payload] so a torn write at the
+ * end of the file (crash mid-append) is detected and discarded on replay.
+ * Records are buffered by append() and made durable by sync(); concurrent
+ * callers of sync() share a single write + fsync (group commit). If the write
+ * or the fsync fails, the file is cut back to its last durable record and the
+ * journal fails for good: the records that weren't durable are dropped, later
+ * ones are never written, and every sync() for them returns false. The caller
+ * has already applied them in memory, so it must stop saving (see
+ * BankSystem::isReadOnly); otherwise a save would persist operations that
+ * were reported as failed.
+ *
+ * Checkpoints rotate() the journal: the records so far move to a sealed file
+ * (path + ".sealed") that replay() reads first, and dropSealed() deletes it
+ * once a snapshot covering them is durable.
+ *
+ * Each journal file starts a numbered segment (rotate() and reset() start the
+ * next one; a sealed file carries the number of the newest segment in it). A
+ * snapshot records the newest segment it covers, so replay() skips the files
+ * it already has and only the tail after the last checkpoint is read.
+ *
+ * Transaction IDs, times and amounts are stored as integers (see Money). A
+ * file without the journal header is moved aside (path + ".old"), not replayed.
+ */
+class Journal {
+public:
+    enum RecordType : uint8_t {
+        CREATE_ACCOUNT = 1,
+        CLOSE_ACCOUNT  = 2,
+        DEPOSIT        = 3,
+        WITHDRAWAL     = 4,
+        INTEREST_ACCRUED = 5      // Savings accrual; amount is the posted deposit (may be zero)
+    };
+
+    struct Record {
+        RecordType type;
+        std::string accountId;
+        // CREATE_ACCOUNT fields
+        std::string customerName;
+        std::string accountType;
+        std::string password;
+        Money transactionFee;     // Checking only
+        InterestRate interestRate; // Savings only
+        // DEPOSIT / WITHDRAWAL / INTEREST_ACCRUED fields
+        TransactionId transactionId;
+        Money amount;
+        // Seconds since the Unix epoch; CREATE_ACCOUNT: creation (Savings: accrued-through) time,
+        // INTEREST_ACCRUED: the new accrued-through time
+        int64_t timestamp;
+        int64_t accrualCarry;     // INTEREST_ACCRUED only: sub-cent interest carried forward
+        // Balance of the account after the record was applied (all but CLOSE_ACCOUNT)
+        Money balance;
+
+        Record() : type(DEPOSIT), timestamp(0), accrualCarry(0) {}
+    };
+
+    // What the last replay() read
+    struct ReplayStats {
+        size_t records;           // Records applied
+        uint64_t bytes;           // Journal bytes they took
+        uint64_t skippedBytes;    // Journal bytes a snapshot already covered
+        double seconds;
+    };
+
+    explicit Journal(const std::string& path = "data/bank.journal");
+    ~Journal();
+
+    bool open();                               // Mutator: Opens (or creates) the journal file for appending
+    void close();                              // Mutator: Flushes pending records and closes the file
+
+    uint64_t append(const Record& record);     // Mutator: Buffers a record, returns its sequence number
+    uint64_t appendAll(const std::vector<Record>& records);  // Mutator: Buffers records in one go, returns the last sequence
+    bool sync(uint64_t sequence);              // Mutator: Blocks until the record is durable (group commit), false on I/O failure
+    bool commit();                             // Mutator: Makes every appended record durable, false on I/O failure
+
+    // Reads every intact record in order (sealed ones first) of the segments after
+    // coveredSegment; a torn tail is truncated away. Call before open().
+    size_t replay(const std::function<void(const Record&)>& apply, uint64_t coveredSegment = 0);
+    void reset();                              // Mutator: Discards all records, sealed ones too (after a full save)
+    bool rotate();                             // Mutator: Seals the records so far, continues in an empty file
+    void dropSealed();                         // Mutator: Deletes the sealed records (a snapshot covers them)
+
+    std::string getPath() const;               // Getter: Returns the journal file path
+    std::string getSealedPath() const;         // Getter: Returns the sealed journal file path
+    uint64_t getSyncCount() const;             // Getter: Returns the number of fsyncs issued
+    uint64_t getSegment() const;               // Getter: Returns the segment number of the current file
+    uint64_t getSize() const;                  // Getter: Returns the current file size, pending records included
+    uint64_t getSealedSize() const;            // Getter: Returns the sealed file size (0 if there is none)
+    bool isFailed() const;                     // Getter: Whether a flush failed (nothing more is written)
+    ReplayStats getLastReplay() const;         // Getter: Returns what the last replay() read
+
+private:
+    std::string path;
+    int fd;
+    std::string pending;                       // Encoded records not yet written
+    uint64_t nextSequence;
+    uint64_t durableSequence;
+    uint64_t syncCount;
+    bool failed;                               // A flush failed; pending records were dropped
+    bool flushing;
+    uint64_t segment;                          // Segment number of the current file
+    uint64_t fileBytes;                        // Bytes written to the current file
+    ReplayStats lastReplay;
+    mutable std::mutex mutex;
+    std::condition_variable flushed;
+
+    bool writeAndSync(const std::string& buffer, uint64_t fileOffset);
+    bool restartFile(const std::string& contents);
+};
+
+#endif // JOURNAL_H
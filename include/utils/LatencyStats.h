@@ -0,0 +1,118 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Call counters and latency histograms for the public BankSystem operations.
+ *
+ * A call is timed with the CPU timestamp counter (steady_clock elsewhere) and
+ * lands in a log-bucketed histogram: four buckets per power of two, so a
+ * reported percentile is within 12.5% of the true latency. Recording takes no
+ * lock: the first STRIPES - 1 threads to record each own a copy of the
+ * counters and bump them with plain relaxed stores (no read-modify-write);
+ * later threads share stripe 0 through relaxed fetch_add. Readers sum the
+ * stripes. Ticks are converted to time only when the statistics are written.
+ *
+ * BankSystem records through BANK_STATS_SCOPE, which expands to nothing unless
+ * the build defines BANK_STATS (make STATS=0 compiles the timing out).
+ */
+class LatencyStats {
+public:
+    enum Operation {
+        CREATE_ACCOUNT,
+        CLOSE_ACCOUNT,
+        VALIDATE_ACCOUNT,
+        DEPOSIT,
+        WITHDRAW,
+        LOAD_DATA,
+        SAVE_DATA,
+        APPLY_INTEREST,
+        APPLY_BATCH,
+        CHECKPOINT,
+        OPERATION_COUNT
+    };
+
+    static const size_t BUCKETS = 252;      // 0-3, then 4 per power of two up to 2^64 ticks
+    static const size_t STRIPES = 16;
+    static const size_t SHARED_STRIPE = 0;
+
+    // Times one call from construction to destruction
+    class Scope {
+        LatencyStats& stats;
+        Operation operation;
+        uint64_t start;
+
+    public:
+        Scope(LatencyStats& owner, Operation op) : stats(owner), operation(op), start(ticks()) {}
+        ~Scope() { stats.record(operation, ticks() - start); }
+    };
+
+    LatencyStats();
+
+    void record(Operation op, uint64_t elapsedTicks) {  // Mutator: Adds one call (lock-free)
+        size_t index = stripeIndex();
+        Stripe& stripe = stripes[index];
+        std::atomic<uint64_t>& bucket = stripe.buckets[op][bucketFor(elapsedTicks)];
+        std::atomic<uint64_t>& total = stripe.totalTicks[op];
+        if (index != SHARED_STRIPE) {
+            // Only this thread writes its stripe
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            total.store(total.load(std::memory_order_relaxed) + elapsedTicks, std::memory_order_relaxed);
+        } else {
+            bucket.fetch_add(1, std::memory_order_relaxed);
+            total.fetch_add(elapsedTicks, std::memory_order_relaxed);
+        }
+    }
+
+    void write(std::ostream& out) const;    // Accessor: Table of calls, mean and percentiles per operation
+    void reset();                           // Mutator: Zeroes every counter
+
+    static const char* operationName(Operation op);  // Utility: "deposit", "saveData", ...
+
+    static uint64_t ticks() {               // Utility: Current timestamp counter value
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static size_t bucketFor(uint64_t value) {  // Utility: Histogram bucket of a tick count
+        if (value < 4) return static_cast<size_t>(value);
+        unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(value));
+        return 4 * (exponent - 1) + static_cast<size_t>((value >> (exponent - 2)) & 3);
+    }
+    static uint64_t bucketLow(size_t bucket);   // Utility: Smallest tick count of a bucket
+
+private:
+    struct Stripe {
+        std::atomic<uint64_t> buckets[OPERATION_COUNT][BUCKETS];
+        std::atomic<uint64_t> totalTicks[OPERATION_COUNT];
+    };
+
+    std::unique_ptr<Stripe[]> stripes;
+    uint64_t startTicks;                    // Clock pair for converting ticks to nanoseconds
+    std::chrono::steady_clock::time_point startTime;
+
+    static size_t stripeIndex() {
+        static thread_local size_t index = claimStripe();
+        return index;
+    }
+    static size_t claimStripe();            // Next free owned stripe, else SHARED_STRIPE
+    double nanosPerTick() const;
+};
+
+#ifdef BANK_STATS
+#define BANK_STATS_SCOPE(stats, op) LatencyStats::Scope latencyScope(stats, LatencyStats::op)
+#else
+#define BANK_STATS_SCOPE(stats, op) ((void)0)
+#endif
+
+#endif // LATENCY_STATS_H
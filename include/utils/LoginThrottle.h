@@ -0,0 +1,41 @@
+#ifndef LOGIN_THROTTLE_H
+#define LOGIN_THROTTLE_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Bank-wide throttle on failed logins: a token bucket holding burst tokens,
+ * refilled at rate tokens per second. Every login attempt takes a token
+ * before any account is looked up and a successful login gives it back, so
+ * only failures drain the bucket. Once a brute-force storm has emptied it,
+ * each further attempt is turned away with a clock read and one atomic
+ * operation, without touching account data or running the password KDF.
+ *
+ * The bucket is a single atomic time (the generic cell rate algorithm):
+ * the moment every token taken so far will have been refilled. A token is
+ * available while that moment is less than burst refills ahead of now.
+ */
+class LoginThrottle {
+public:
+    static const uint32_t DEFAULT_RATE = 50;     // Failed logins per second, sustained
+    static const uint32_t DEFAULT_BURST = 500;   // Failed logins allowed at once after a quiet spell
+
+private:
+    std::atomic<int64_t> refilledAt;     // Steady-clock nanoseconds
+    std::atomic<int64_t> tokenNanos;     // Refill time of one token (0: throttle off)
+    std::atomic<int64_t> burstNanos;     // Refill time of a full bucket
+    std::atomic<uint64_t> rejected;
+
+    static int64_t nowNanos();
+
+public:
+    explicit LoginThrottle(uint32_t rate = DEFAULT_RATE, uint32_t burst = DEFAULT_BURST);
+
+    void configure(uint32_t rate, uint32_t burst);   // Mutator: New rate (0 turns it off) and bucket size; starts full
+    bool tryAcquire();                               // Mutator: Takes a token; false (and counted) if there is none
+    void release();                                  // Mutator: Returns a token taken by tryAcquire()
+    uint64_t getRejected() const;                    // Getter: Attempts turned away since start-up
+};
+
+#endif // LOGIN_THROTTLE_H
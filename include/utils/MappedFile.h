@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * Read-only memory mapping of a whole file (RAII).
+ * Lets the loaders scan file contents in place without copying them
+ * into std::string lines first.
+ */
+class MappedFile {
+private:
+    const char* mapping;
+    size_t length;
+    bool opened;
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);  // Mutator: Maps the file, returns false if it can't be mapped
+    void close();                        // Mutator: Unmaps the file
+
+    const char* data() const;            // Getter: Returns the first byte of the file (nullptr if empty)
+    size_t size() const;                 // Getter: Returns the file size in bytes
+    bool isOpen() const;                 // Getter: Returns whether a file is mapped
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,47 @@
+#ifndef PASSWORD_HASH_H
+#define PASSWORD_HASH_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Salted, memory-hard password hashes (scrypt, RFC 7914, over PBKDF2-HMAC-
+ * SHA256), stored in the password column as one CSV-safe field:
+ *
+ *     $scrypt$<cost>$<r>$<p>$<salt, hex>$<key, hex>
+ *
+ * The cost is log2 of scrypt's N: each step up doubles both the CPU time and
+ * the memory (128 * r * N bytes, 16 MiB at cost 14) of every hash and every
+ * login. A hash keeps its own parameters, so changing the cost only affects
+ * hashes made afterwards. Stored parameters needing more than MAX_MEMORY are
+ * rejected, so one bad row can't make a login allocate gigabytes.
+ */
+class PasswordHash {
+public:
+    static const unsigned MIN_COST = 1;
+    static const unsigned MAX_COST = 18;                // MAX_MEMORY at BLOCK_FACTOR
+    static const unsigned DEFAULT_COST = 14;
+    static const uint32_t BLOCK_FACTOR = 8;    // scrypt r
+    static const size_t SALT_SIZE = 16;
+    static const size_t KEY_SIZE = 32;
+    static const uint64_t MAX_MEMORY = uint64_t(256) << 20;   // scrypt table of one hash, in bytes
+
+    static std::string hash(const std::string& password, unsigned cost);         // Utility: New salted hash (cost clamped)
+    static bool verify(const std::string& password, const std::string& stored);  // Utility: Checks a hash (or a legacy plaintext credential)
+    static bool isHash(const std::string& stored);                               // Utility: Whether stored is a hash at all
+    static unsigned costOf(const std::string& stored);                           // Utility: Cost of a hash (0 for plaintext)
+
+    // The primitives underneath (public so they can be checked against published test vectors)
+    static void sha256(const uint8_t* data, size_t size, uint8_t digest[32]);
+    static void pbkdf2Sha256(const uint8_t* password, size_t passwordSize, const uint8_t* salt, size_t saltSize,
+                             uint32_t iterations, uint8_t* out, size_t outSize);
+    // n must be a power of two and 128 * r * n at most MAX_MEMORY
+    static void scrypt(const uint8_t* password, size_t passwordSize, const uint8_t* salt, size_t saltSize,
+                       uint64_t n, uint32_t r, uint32_t p, uint8_t* out, size_t outSize);
+
+private:
+    PasswordHash();
+};
+
+#endif // PASSWORD_HASH_H
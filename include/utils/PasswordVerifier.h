@@ -0,0 +1,66 @@
+#ifndef PASSWORD_VERIFIER_H
+#define PASSWORD_VERIFIER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * Worker pool for the password KDF (see PasswordHash). Logins hand their
+ * check to the pool and wait, so no account lock is held while the hash
+ * runs; concurrent logins and bulk work (migrating a file of plaintext
+ * credentials, the CREATE/CLOSE entries of a batch) are spread across the
+ * workers. Since only the workers hash, at most one KDF per worker is in
+ * flight however many sessions log in at once, which also bounds the
+ * memory the hashes take.
+ */
+class PasswordVerifier {
+public:
+    // One unit of KDF work
+    struct Job {
+        enum Type { VERIFY, HASH };
+
+        Type type;
+        std::string password;
+        std::string credential;   // VERIFY: the stored credential; HASH: the new hash (output)
+        unsigned cost;            // HASH only
+        bool matched;             // VERIFY: whether the password matched (output)
+
+        Job() : type(VERIFY), cost(0), matched(false) {}
+    };
+
+private:
+    // Jobs of one run() call; workers claim them one at a time
+    struct Batch {
+        Job* jobs;
+        size_t count;
+        size_t next;              // First job not yet claimed
+        size_t remaining;         // Jobs not yet finished
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work;
+    std::condition_variable finished;
+    std::deque<Batch*> queue;     // Batches with unclaimed jobs, oldest first
+    bool stopping;
+
+    void workerLoop();            // Worker thread body
+
+public:
+    explicit PasswordVerifier(unsigned threads = 0);   // 0: one worker per hardware thread
+    ~PasswordVerifier();          // Finishes the queued jobs, then joins the workers
+
+    PasswordVerifier(const PasswordVerifier&) = delete;
+    PasswordVerifier& operator=(const PasswordVerifier&) = delete;
+
+    void run(std::vector<Job>& jobs);                                    // Mutator: Runs every job; returns when all are done
+    bool verify(const std::string& password, const std::string& stored);  // Utility: One check on a worker
+    std::string hash(const std::string& password, unsigned cost);        // Utility: One new hash on a worker
+    size_t getThreadCount() const;                                       // Getter: Returns the number of workers
+};
+
+#endif // PASSWORD_VERIFIER_H
@@ -0,0 +1,137 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../System details/Account.h"
+#include "../System details/Transaction.h"
+#include "AccountPool.h"
+#include "FileHandler.h"
+
+/**
+ * Versioned binary snapshot of the BankSystem accounts.
+ *
+ * Layout: [header][account records][string table]
+ * Records are fixed width and refer to their text fields by (offset, length)
+ * into the string table, so the accounts load with a single mapping and no
+ * text parsing. The header carries the counts and a CRC-32 per section.
+ *
+ * The header records where the snapshot's state sits in the append-only
+ * transactions file (rows and bytes) and the newest journal segment the
+ * snapshot covers (see Journal), so writing a snapshot costs O(accounts),
+ * however long the history. The ledger itself is kept next to it in binary
+ * (path + ".ledger"): the Transaction records as they are in memory, appended
+ * one frame per save or checkpoint alongside the rows of the transactions
+ * file, so start-up copies them instead of parsing the CSV text. Each frame
+ * records the transactions file size it brings the ledger up to; a ledger
+ * that doesn't end where that file ends (a save stopped between the two) is
+ * rebuilt from the CSV. Amounts are integer cents (see Money) and interest
+ * rates millionths. Snapshots of another version are rejected and the CSV
+ * files, which are always saved alongside, are loaded instead.
+ */
+class Snapshot {
+public:
+    static const uint32_t VERSION = 1;
+
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t accountCount;
+        uint64_t stringTableSize;
+        uint64_t transactionRows;     // Ledger rows in the transactions file when the snapshot was taken
+        uint64_t transactionBytes;    // ... and the file size at that point
+        uint64_t journalSegment;      // Journal segments up to this one are in the snapshot
+        uint32_t accountsChecksum;
+        uint32_t stringsChecksum;
+        uint32_t reserved;
+        uint32_t headerChecksum;      // CRC of every header byte before this field
+    };
+
+    struct AccountRecord {
+        StringRef id;
+        StringRef name;
+        StringRef type;
+        StringRef password;
+        int64_t balanceCents;
+        int64_t param;                // Fee in cents (Checking) or rate in millionths (Savings)
+        int64_t accruedThrough;       // Savings only: interest is booked up to this time
+        int64_t accrualCarry;         // Savings only: unposted interest in millionths of a cent
+        uint8_t kind;                 // Account::Kind
+        uint8_t reserved[7];
+    };
+
+    // Ledger file: [LedgerHeader] then frames of [LedgerFrame][rowCount Transaction records]
+    struct LedgerHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;          // sizeof(Transaction)
+    };
+
+    struct LedgerFrame {
+        uint64_t firstRow;            // Ledger row of the frame's first record
+        uint64_t rowCount;
+        uint64_t transactionBytes;    // Size of the transactions file once it held these rows
+        uint32_t rowsChecksum;
+        uint32_t frameChecksum;       // CRC of every frame byte before this field
+    };
+
+    // Snapshot contents assembled piece by piece, so a background checkpoint can
+    // capture accounts one shard at a time and write the file off every lock
+    class Image {
+        std::string strings;
+        std::vector<AccountRecord> accountRecords;
+        FileHandler::ChangeBase base;
+        friend class Snapshot;
+
+    public:
+        void setBase(const FileHandler::ChangeBase& position);  // Mutator: Sets the ledger position and journal segment covered
+        void addAccount(const Account* acc);               // Mutator: Copies an account's state
+        void reserve(size_t accounts);                     // Mutator: Pre-sizes the record list
+        size_t getAccountCount() const;                    // Getter: Returns the number of accounts
+        // Recreates the captured accounts in pool (e.g. to write the accounts CSV)
+        void restoreAccounts(std::vector<Account*>& accounts, AccountPool& pool) const;
+    };
+
+private:
+    std::string snapshotFilePath;
+
+public:
+    Snapshot(const std::string& snapFile = "data/bank.snapshot");
+
+    bool exists() const;                       // Accessor: Returns whether a snapshot file is present
+    std::string getPath() const;               // Getter: Returns the snapshot file path
+    std::string getLedgerPath() const;         // Getter: Returns the ledger file path
+
+    // Writes the accounts and their position in the transactions file and journal
+    // atomically (temp file + fsync + rename)
+    bool save(const std::vector<Account*>& accounts, const FileHandler::ChangeBase& position) const;
+    bool write(const Image& image) const;      // Writes a captured image the same way
+
+    // Loads a snapshot, creating accounts in pool and returning its position in position;
+    // returns false (leaving accounts untouched) if it is missing or corrupt
+    bool load(std::vector<Account*>& accounts, AccountPool& pool, FileHandler::ChangeBase& position) const;
+
+    // Ledger file. transactionBytes is the size of the transactions file holding the same rows.
+    // appendLedger adds rows (ledger rows firstRow on) as one synced frame; writeLedger replaces
+    // the file atomically. loadLedger appends the rows of every intact frame to transactions and
+    // returns false if there is no usable ledger file.
+    bool appendLedger(const Transaction* rows, size_t count, size_t firstRow, uint64_t transactionBytes) const;
+    bool writeLedger(const std::vector<Transaction>& rows, uint64_t transactionBytes) const;
+    bool loadLedger(std::vector<Transaction>& transactions, uint64_t& transactionBytes) const;
+};
+
+// Converters between the binary snapshot and the CSV files (migration and debugging). The
+// CSV side is accounts.csv with its change segment (accounts.csv.delta) folded in; the
+// snapshot's ledger file is rebuilt from transactions.csv.
+bool convertCSVToSnapshot(const std::string& accFile, const std::string& transFile,
+                          const std::string& snapFile);
+bool convertSnapshotToCSV(const std::string& snapFile, const std::string& accFile);
+
+#endif // SNAPSHOT_H
@@ -12,10 +12,21 @@
 #include <string>
 #include <fstream>
 #include <limits> // For std::numeric_limits
+#include <ctime>
+#include <cstdlib>
+#include <chrono>
 
 // Include header files from the project
 #include "include/Bank System/BankSystem.h"
 #include "include/Viewer POV/Menu.h"
+#include "include/Bank System/BatchProcessor.h"
+#include "include/utils/Snapshot.h"
+
+// Reads one amount token ("12", "12.5", "12.50") into exact cents, false if it isn't a number
+bool readAmount(Money& amount) {
+    std::string text;
+    return (std::cin >> text) && Money::parse(text, amount);
+}
 
 /**
  * Main function for the Banking System application
@@ -23,9 +34,99 @@
  */
  //MENU was enhanced using AI
 
-int main() {
+// Writes the per-operation statistics to path; no-op without --stats-file
+bool writeStatsFile(const BankSystem& bankSystem, const std::string& path) {
+    if (path.empty()) return true;
+    std::ofstream out(path.c_str());
+    bankSystem.writeStats(out);
+    if (!out) {
+        std::cerr << "Error writing statistics to " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// After a failed operation: whether it failed because the journal can't be written, which ends the session
+bool journalFailed(const BankSystem& bankSystem) {
+    if (!bankSystem.isReadOnly()) return false;
+    std::cout << "The bank's journal could not be written, so this operation was not saved and nothing "
+              << "can be changed until the Banking System is restarted." << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // Settings that may precede any mode:
+    //   --stats-file path           write the operation statistics there when the session ends
+    //   --checkpoint-interval secs  background snapshot period (0 = off)
+    //   --checkpoint-every count    background snapshot after this many changes (0 = off)
+    //   --checkpoint-bytes bytes    background snapshot once the journal is this large (0 = off)
+    //   --password-cost n           password hash cost, log2 of the scrypt work factor (each step doubles it)
+    //   --login-rate n              failed logins per second allowed across the bank (0 = no limit)
+    //   --login-burst n             failed logins allowed at once before that rate applies
+    std::string statsFile;
+    long checkpointSeconds = 300;
+    unsigned long long checkpointEvery = 10000;
+    unsigned long long checkpointBytes = 64ULL * 1024 * 1024;
+    unsigned long passwordCost = PasswordHash::DEFAULT_COST;
+    unsigned long loginRate = LoginThrottle::DEFAULT_RATE;
+    unsigned long loginBurst = LoginThrottle::DEFAULT_BURST;
+    int first = 1;
+    while (argc > first + 1) {
+        std::string setting = argv[first];
+        if (setting == "--stats-file") {
+            statsFile = argv[first + 1];
+        } else if (setting == "--checkpoint-interval") {
+            checkpointSeconds = std::strtol(argv[first + 1], nullptr, 10);
+        } else if (setting == "--checkpoint-every") {
+            checkpointEvery = std::strtoull(argv[first + 1], nullptr, 10);
+        } else if (setting == "--checkpoint-bytes") {
+            checkpointBytes = std::strtoull(argv[first + 1], nullptr, 10);
+        } else if (setting == "--password-cost") {
+            passwordCost = std::strtoul(argv[first + 1], nullptr, 10);
+        } else if (setting == "--login-rate") {
+            loginRate = std::strtoul(argv[first + 1], nullptr, 10);
+        } else if (setting == "--login-burst") {
+            loginBurst = std::strtoul(argv[first + 1], nullptr, 10);
+        } else {
+            break;
+        }
+        first += 2;
+    }
+
+    // Snapshot/CSV conversion for migration and debugging, no interactive session
+    if (argc > first) {
+        std::string option = argv[first];
+        if (option == "--csv-to-snapshot" || option == "--snapshot-to-csv") {
+            std::string snapFile = (argc > first + 1) ? argv[first + 1] : "data/bank.snapshot";
+            bool ok = (option == "--csv-to-snapshot")
+                ? convertCSVToSnapshot("data/accounts.csv", "data/transactions.csv", snapFile)
+                : convertSnapshotToCSV(snapFile, "data/accounts.csv");
+            std::cout << (ok ? "Conversion complete." : "Conversion failed.") << std::endl;
+            return ok ? 0 : 1;
+        }
+        // Headless batch mode: process an operations file without the menus
+        if (option == "--batch" && argc > first + 1) {
+            std::string resultsFile = (argc > first + 2) ? argv[first + 2] : std::string(argv[first + 1]) + ".results";
+            BankSystem bankSystem("data/accounts.csv", "data/transactions.csv", "data/bank.journal", "data/bank.snapshot",
+                                  16, AccountIdAllocator::DEFAULT_LAST, static_cast<unsigned>(passwordCost));
+            bankSystem.setLoginThrottle(static_cast<uint32_t>(loginRate), static_cast<uint32_t>(loginBurst));
+            bankSystem.startPersister(std::chrono::seconds(checkpointSeconds), checkpointEvery, checkpointBytes);
+            bool ok = runBatchFile(bankSystem, argv[first + 1], resultsFile);
+            return (writeStatsFile(bankSystem, statsFile) && ok) ? 0 : 1;
+        }
+        std::cerr << "Unknown option: " << option << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [--stats-file file] [--checkpoint-interval secs]"
+                  << " [--checkpoint-every count] [--checkpoint-bytes bytes] [--password-cost n]"
+                  << " [--login-rate n] [--login-burst n] [--batch ops.csv [results.csv] | "
+                  << "--csv-to-snapshot [file] | --snapshot-to-csv [file]]" << std::endl;
+        return 1;
+    }
+
     // Initialize the banking system with data file paths
-    BankSystem bankSystem("data/accounts.csv", "data/transactions.csv");
+    BankSystem bankSystem("data/accounts.csv", "data/transactions.csv", "data/bank.journal", "data/bank.snapshot",
+                          16, AccountIdAllocator::DEFAULT_LAST, static_cast<unsigned>(passwordCost));
+    bankSystem.setLoginThrottle(static_cast<uint32_t>(loginRate), static_cast<uint32_t>(loginBurst));
+    bankSystem.startPersister(std::chrono::seconds(checkpointSeconds), checkpointEvery, checkpointBytes);
     int choice;
     
     std::cout << "Welcome to the Banking System\n";
@@ -40,13 +141,13 @@ int main() {
             // Handle non-numeric input
             std::cin.clear(); // Clear the error flag
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Discard invalid input
-            std::cout << "Invalid input. Please enter a number between 1 and 5." << std::endl;
+            std::cout << "Invalid input. Please enter a number between 1 and 6." << std::endl;
             continue; // Skip to next iteration of the loop
         }
         
-        // Validate input range (1-5)
-        if (choice < 1 || choice > 5) {
-            std::cout << "Invalid choice. Please enter a number between 1 and 5." << std::endl;
+        // Validate input range (1-6)
+        if (choice < 1 || choice > 6) {
+            std::cout << "Invalid choice. Please enter a number between 1 and 6." << std::endl;
             continue; // Skip to next iteration of the loop
         }
         
@@ -54,7 +155,7 @@ int main() {
             case 1: {
                 // Create new account
                 std::string name, accountType, password;
-                double initialBalance;
+                Money initialBalance;
                 
                 std::cin.ignore();
                 std::cout << "Enter your name: ";
@@ -64,13 +165,18 @@ int main() {
                 std::cin >> accountType;
                 
                 std::cout << "Enter initial deposit amount: $";
-                std::cin >> initialBalance;
+                if (!readAmount(initialBalance)) {
+                    std::cout << "Invalid input. Please enter a numeric amount." << std::endl;
+                    break;
+                }
                 
                 std::cout << "Create a password: ";
                 std::cin >> password;
                 
                 if (bankSystem.createAccount(name, accountType, initialBalance, password)) {
                     std::cout << "Account created successfully!" << std::endl;
+                } else if (journalFailed(bankSystem)) {
+                    running = false;
                 } else {
                     std::cout << "Failed to create account. Please try again." << std::endl;
                 }
@@ -100,13 +206,13 @@ int main() {
                             // Handle non-numeric input
                             std::cin.clear(); // Clear the error flag
                             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Discard invalid input
-                            std::cout << "Invalid input. Please enter a number between 1 and 5." << std::endl;
+                            std::cout << "Invalid input. Please enter a number between 1 and 6." << std::endl;
                             continue; // Skip to next iteration of the loop
                         }
                         
-                        // Validate input range (1-5)
-                        if (accountChoice < 1 || accountChoice > 5) {
-                            std::cout << "Invalid choice. Please enter a number between 1 and 5." << std::endl;
+                        // Validate input range (1-6)
+                        if (accountChoice < 1 || accountChoice > 6) {
+                            std::cout << "Invalid choice. Please enter a number between 1 and 6." << std::endl;
                             continue; // Skip to next iteration of the loop
                         }
                         
@@ -115,32 +221,32 @@ int main() {
                                 // Check balance
                                 Account* acc = bankSystem.findAccount(accountId);
                                 if (acc) {
-                                    std::cout << "Account Balance: $" << std::fixed 
-                                              << std::setprecision(2) << acc->getBalance() 
-                                              << std::endl;
+                                    std::cout << "Account Balance: $" << acc->getBalance() << std::endl;
                                 }
                                 break;
                             }
                             case 2: {
                                 // Deposit
-                                double amount;
+                                Money amount;
                                 std::cout << "Enter amount to deposit: $";
                                 
                                 // Input validation for deposit amount
-                                if (!(std::cin >> amount)) {
+                                if (!readAmount(amount)) {
                                     std::cin.clear(); // Clear the error flag
                                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Discard invalid input
                                     std::cout << "Invalid input. Please enter a numeric amount." << std::endl;
                                     break;
                                 }
                                 
-                                if (amount <= 0) {
+                                if (!amount.isPositive()) {
                                     std::cout << "Amount must be greater than zero." << std::endl;
                                     break;
                                 }
                                 
                                 if (bankSystem.deposit(accountId, amount)) {
                                     std::cout << "Deposit successful!" << std::endl;
+                                } else if (journalFailed(bankSystem)) {
+                                    accountMenuRunning = running = false;
                                 } else {
                                     std::cout << "Deposit failed. Please try again." << std::endl;
                                 }
@@ -148,24 +254,26 @@ int main() {
                             }
                             case 3: {
                                 // Withdraw
-                                double amount;
+                                Money amount;
                                 std::cout << "Enter amount to withdraw: $";
                                 
                                 // Input validation for withdrawal amount
-                                if (!(std::cin >> amount)) {
+                                if (!readAmount(amount)) {
                                     std::cin.clear(); // Clear the error flag
                                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Discard invalid input
                                     std::cout << "Invalid input. Please enter a numeric amount." << std::endl;
                                     break;
                                 }
                                 
-                                if (amount <= 0) {
+                                if (!amount.isPositive()) {
                                     std::cout << "Amount must be greater than zero." << std::endl;
                                     break;
                                 }
                                 
                                 if (bankSystem.withdraw(accountId, amount)) {
                                     std::cout << "Withdrawal successful!" << std::endl;
+                                } else if (journalFailed(bankSystem)) {
+                                    accountMenuRunning = running = false;
                                 } else {
                                     std::cout << "Withdrawal failed. Insufficient funds or invalid amount." 
                                               << std::endl;
@@ -181,13 +289,43 @@ int main() {
                                 if (bankSystem.closeAccount(accountId, confirmPassword)) {
                                     std::cout << "Account closed successfully!" << std::endl;
                                     accountMenuRunning = false;
+                                } else if (journalFailed(bankSystem)) {
+                                    accountMenuRunning = running = false;
                                 } else {
                                     std::cout << "Failed to close account. Incorrect password." 
                                               << std::endl;
                                 }
                                 break;
                             }
-                            case 5:
+                            case 5: {
+                                // Statement: full history, one page at a time
+                                StatementPage page;
+                                std::string pageToken;
+                                do {
+                                    if (!bankSystem.getStatement(accountId, 0, std::time(nullptr), pageToken, page, 10)) {
+                                        break;
+                                    }
+                                    if (page.transactions.empty()) {
+                                        std::cout << "No transactions found." << std::endl;
+                                        break;
+                                    }
+                                    for (const Transaction& trans : page.transactions) {
+                                        std::cout << trans.getDate() << "  " << std::left << std::setw(10)
+                                                  << trans.getTypeName() << std::right << " $"
+                                                  << trans.getAmount() << std::endl;
+                                    }
+
+                                    pageToken = page.nextPageToken;
+                                    if (!pageToken.empty()) {
+                                        std::string more;
+                                        std::cout << "Show more? (y/n): ";
+                                        std::cin >> more;
+                                        if (more != "y" && more != "Y") break;
+                                    }
+                                } while (!pageToken.empty());
+                                break;
+                            }
+                            case 6:
                                 // Back to main menu
                                 accountMenuRunning = false;
                                 break;
@@ -209,8 +347,16 @@ int main() {
                 bankSystem.runPasswordCracker();
                 break;
             case 5:
+                // Operation statistics (admin)
+                bankSystem.writeStats(std::cout);
+                if (!statsFile.empty() && writeStatsFile(bankSystem, statsFile)) {
+                    std::cout << "Statistics written to " << statsFile << std::endl;
+                }
+                break;
+            case 6:
                 // Exit
                 running = false;
+                writeStatsFile(bankSystem, statsFile);
                 std::cout << "Thank you for using the Banking System. Goodbye!" << std::endl;
                 break;
             default:
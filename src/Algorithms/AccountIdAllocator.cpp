@@ -0,0 +1,75 @@
+#include "../../include/utils/AccountIdAllocator.h"
+
+AccountIdAllocator::AccountIdAllocator(uint32_t first, uint32_t last)
+    : first(first), last(last < AccountId::MAX_VALUE ? last : AccountId::MAX_VALUE), cursor(0), used(0) {
+    if (this->last < this->first) this->last = this->first;
+
+    size_t capacity = getCapacity();
+    words.assign((capacity + 63) / 64, 0);
+
+    // Mark the padding bits past the end of the range as taken
+    size_t tail = capacity % 64;
+    if (tail != 0) {
+        words.back() = ~0ull << tail;
+    }
+}
+
+void AccountIdAllocator::markUsed(AccountId id) {
+    if (!id.isValid() || id.getValue() < first || id.getValue() > last) return;
+
+    size_t offset = id.getValue() - first;
+    uint64_t bit = 1ull << (offset % 64);
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t& word = words[offset / 64];
+    if ((word & bit) == 0) {
+        word |= bit;
+        ++used;
+    }
+}
+
+// Skips over full words; each word is passed at most once since bits are never cleared
+AccountId AccountIdAllocator::allocateLocked() {
+    while (cursor < words.size() && words[cursor] == ~0ull) {
+        ++cursor;
+    }
+    if (cursor == words.size()) return AccountId();
+
+    uint64_t& word = words[cursor];
+    unsigned bit = static_cast<unsigned>(__builtin_ctzll(~word));
+    word |= 1ull << bit;
+    ++used;
+    return AccountId(first + static_cast<uint32_t>(cursor * 64 + bit));
+}
+
+AccountId AccountIdAllocator::allocate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocateLocked();
+}
+
+size_t AccountIdAllocator::allocate(size_t count, std::vector<AccountId>& ids) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t allocated = 0;
+    for (; allocated < count; ++allocated) {
+        AccountId id = allocateLocked();
+        if (!id.isValid()) break;
+        ids.push_back(id);
+    }
+    return allocated;
+}
+
+uint32_t AccountIdAllocator::getFirst() const {
+    return first;
+}
+
+uint32_t AccountIdAllocator::getLast() const {
+    return last;
+}
+
+size_t AccountIdAllocator::getUsedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return used;
+}
+
+size_t AccountIdAllocator::getCapacity() const {
+    return static_cast<size_t>(last - first) + 1;
+}
@@ -0,0 +1,135 @@
+#include "../../include/utils/AccountIndex.h"
+
+namespace {
+
+const size_t INITIAL_CAPACITY = 16;
+
+} // namespace
+
+AccountIndex::AccountIndex() : count(0), mask(0) {}
+
+// Fibonacci hashing spreads consecutive account numbers across the table
+size_t AccountIndex::home(uint32_t key) const {
+    return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+Account* AccountIndex::find(AccountId id) const {
+    if (count == 0 || !id.isValid()) return nullptr;
+
+    uint32_t key = id.getValue();
+    for (size_t i = home(key);; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.key == key) return slot.account;
+        if (slot.key == AccountId::INVALID) return nullptr;
+    }
+}
+
+bool AccountIndex::contains(AccountId id) const {
+    return find(id) != nullptr;
+}
+
+bool AccountIndex::insert(AccountId id, Account* account) {
+    if (!id.isValid()) return false;
+    // Keep the load factor at or below 1/2 so probe runs stay short
+    if ((count + 1) * 2 > slots.size()) grow();
+
+    uint32_t key = id.getValue();
+    for (size_t i = home(key);; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.key == key) return false;
+        if (slot.key == AccountId::INVALID) {
+            slot.key = key;
+            slot.account = account;
+            ++count;
+            return true;
+        }
+    }
+}
+
+Account* AccountIndex::replace(AccountId id, Account* account) {
+    if (!id.isValid()) return nullptr;
+    if ((count + 1) * 2 > slots.size()) grow();
+
+    uint32_t key = id.getValue();
+    for (size_t i = home(key);; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.key == key) {
+            Account* previous = slot.account;
+            slot.account = account;
+            return previous;
+        }
+        if (slot.key == AccountId::INVALID) {
+            slot.key = key;
+            slot.account = account;
+            ++count;
+            return nullptr;
+        }
+    }
+}
+
+/**
+ * Backward-shift deletion: after emptying a slot, walk the rest of the probe
+ * run and move back any entry whose home position lies at or before the gap.
+ */
+bool AccountIndex::erase(AccountId id) {
+    if (count == 0 || !id.isValid()) return false;
+
+    uint32_t key = id.getValue();
+    size_t i = home(key);
+    while (slots[i].key != key) {
+        if (slots[i].key == AccountId::INVALID) return false;
+        i = (i + 1) & mask;
+    }
+
+    size_t gap = i;
+    for (size_t j = (gap + 1) & mask; slots[j].key != AccountId::INVALID; j = (j + 1) & mask) {
+        size_t ideal = home(slots[j].key);
+        // Distance from ideal to j versus gap to j, modulo the table size
+        if (((j - ideal) & mask) >= ((j - gap) & mask)) {
+            slots[gap] = slots[j];
+            gap = j;
+        }
+    }
+    slots[gap].key = AccountId::INVALID;
+    slots[gap].account = nullptr;
+    --count;
+    return true;
+}
+
+void AccountIndex::clear() {
+    slots.clear();
+    count = 0;
+    mask = 0;
+}
+
+void AccountIndex::reserve(size_t entries) {
+    while (entries * 2 > slots.size()) grow();
+}
+
+size_t AccountIndex::size() const {
+    return count;
+}
+
+bool AccountIndex::empty() const {
+    return count == 0;
+}
+
+void AccountIndex::grow() {
+    size_t capacity = slots.empty() ? INITIAL_CAPACITY : slots.size() * 2;
+    std::vector<Slot> old;
+    old.swap(slots);
+
+    Slot empty = {AccountId::INVALID, nullptr};
+    slots.assign(capacity, empty);
+    mask = capacity - 1;
+
+    for (const Slot& slot : old) {
+        if (slot.key == AccountId::INVALID) continue;
+        for (size_t i = home(slot.key);; i = (i + 1) & mask) {
+            if (slots[i].key == AccountId::INVALID) {
+                slots[i] = slot;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include "../../include/utils/AccountPool.h"
+
+AccountPool::AccountPool() : used(SLOTS_PER_SLAB), liveCount(0) {}
+
+AccountPool::~AccountPool() {
+    clear();
+}
+
+// Reuses the most recently freed slot (still warm in cache), else bumps into the last slab
+AccountPool::Slot* AccountPool::acquireSlot() {
+    if (!freeSlots.empty()) {
+        Slot* slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    if (used == SLOTS_PER_SLAB) {
+        slabs.push_back(std::unique_ptr<Slot[]>(new Slot[SLOTS_PER_SLAB]));
+        used = 0;
+    }
+    Slot* slot = &slabs.back()[used++];
+    slot->live = false;
+    return slot;
+}
+
+// Accounts are single-inheritance, so the object starts at the slot's storage
+AccountPool::Slot* AccountPool::slotOf(Account* account) {
+    return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(account));
+}
+
+// Account has no virtual destructor; the kind tag selects the right one
+void AccountPool::destruct(Account* account) {
+    switch (account->getKind()) {
+        case Account::CHECKING:
+            static_cast<CheckingAccount*>(account)->~CheckingAccount();
+            break;
+        case Account::SAVINGS:
+            static_cast<SavingsAccount*>(account)->~SavingsAccount();
+            break;
+        case Account::BASIC:
+            account->~Account();
+            break;
+    }
+}
+
+void AccountPool::destroy(Account* account) {
+    if (account == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Slot* slot = slotOf(account);
+    destruct(account);
+    slot->live = false;
+    --liveCount;
+    freeSlots.push_back(slot);
+}
+
+/**
+ * Bulk release: walks the slabs in address order, runs the destructor of each
+ * live account (its strings and queues own heap memory), then frees whole
+ * slabs instead of one allocation per account.
+ */
+void AccountPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t s = 0; s < slabs.size(); ++s) {
+        size_t end = (s + 1 == slabs.size()) ? used : SLOTS_PER_SLAB;
+        Slot* slab = slabs[s].get();
+        for (size_t i = 0; i < end; ++i) {
+            if (slab[i].live) {
+                destruct(reinterpret_cast<Account*>(slab[i].storage));
+            }
+        }
+    }
+    slabs.clear();
+    std::vector<Slot*>().swap(freeSlots);
+    used = SLOTS_PER_SLAB;
+    liveCount = 0;
+}
+
+size_t AccountPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return liveCount;
+}
+
+size_t AccountPool::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slabs.size() * SLOTS_PER_SLAB;
+}
@@ -1,10 +1,14 @@
 #include "../../include/utils/Algorithms.h"
 #include <algorithm>
-#include <random>
 #include <stack>
 #include <cctype>
 #include <sstream>
 #include <cmath> // For std::pow
+#include <iostream>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
 
 // Algorithm 1: Binary search (Using map and Array)
 template<typename KeyType, typename ValueType>
@@ -18,21 +22,6 @@ template bool binarySearchMap<std::string, void*>(
     const std::string& key
 );
 
-// Algorithm 2: Generate unique account ID
-std::string generateUniqueAccountId(const std::map<std::string, void*>& existingAccounts) {
-    std::string prefix = "ACC";
-    std::random_device rd;
-    std::mt19937 generator(rd());
-    std::uniform_int_distribution<> distribution(10000, 99999);
-    
-    std::string candidate;
-    do {
-        candidate = prefix + std::to_string(distribution(generator));
-    } while (binarySearchMap(existingAccounts, candidate));
-    
-    return candidate;
-}
-
 // Algorithm 3: Password strength checker using stack
 int checkPasswordStrength(const std::string& password) {
     if (password.length() < 8) return 0; // Too short
@@ -122,4 +111,260 @@ std::vector<std::string> splitString(const std::string& str, char delimiter) {
     }
     
     return tokens;
-}
\ No newline at end of file
+}
+
+// Helper function: Split [begin, end) in place into at most maxFields views
+size_t splitFields(const char* begin, const char* end, char delimiter, FieldView* fields, size_t maxFields) {
+    size_t count = 0;
+    const char* fieldStart = begin;
+
+    while (count < maxFields) {
+        const char* fieldEnd = static_cast<const char*>(
+            std::memchr(fieldStart, delimiter, static_cast<size_t>(end - fieldStart)));
+        if (fieldEnd == nullptr) fieldEnd = end;
+
+        fields[count].data = fieldStart;
+        fields[count].size = static_cast<size_t>(fieldEnd - fieldStart);
+        ++count;
+
+        if (fieldEnd == end) break;
+        fieldStart = fieldEnd + 1;
+    }
+
+    return count;
+}
+
+// Helper function: Thread-safe std::ctime() replacement
+// std::ctime formats into a shared static buffer, which races between sessions
+std::string formatDate(std::time_t time) {
+    char buffer[DATE_TEXT_LENGTH];
+    size_t length = formatDate(time, buffer);
+    return std::string(buffer, length);
+}
+
+// Each thread remembers the text of the last minute it formatted; time zone
+// offsets are whole minutes, so only the seconds differ within that minute and
+// bulk exports call localtime_r once per minute instead of once per row
+size_t formatDate(std::time_t time, char* out) {
+    struct MinuteCache {
+        long long minute;
+        size_t length;
+        char text[32];
+    };
+    static thread_local MinuteCache cache = {-1, 0, {0}};
+
+    long long seconds = static_cast<long long>(time);
+    long long minute = (seconds >= 0) ? seconds / 60 : (seconds - 59) / 60;
+    if (minute != cache.minute || cache.length != DATE_TEXT_LENGTH) {
+        std::tm parts;
+        localtime_r(&time, &parts);
+        cache.length = std::strftime(cache.text, sizeof(cache.text), "%a %b %e %H:%M:%S %Y", &parts);
+        cache.minute = minute;
+        std::memcpy(out, cache.text, cache.length);
+        return cache.length;
+    }
+
+    int second = static_cast<int>(seconds - minute * 60);
+    std::memcpy(out, cache.text, DATE_TEXT_LENGTH);
+    out[17] = static_cast<char>('0' + second / 10);
+    out[18] = static_cast<char>('0' + second % 10);
+    return DATE_TEXT_LENGTH;
+}
+
+namespace {
+
+// Reads an unsigned number from str[i..] skipping leading spaces, advances i
+bool readNumber(const char* str, size_t length, size_t& i, int& value) {
+    while (i < length && str[i] == ' ') ++i;
+    size_t start = i;
+    value = 0;
+    while (i < length && str[i] >= '0' && str[i] <= '9' && i - start < 9) {
+        value = value * 10 + (str[i] - '0');
+        ++i;
+    }
+    return i > start;
+}
+
+} // namespace
+
+// Helper function: Parses "Www Mmm dd hh:mm:ss yyyy" (local time)
+// mktime() is only consulted once per hour of dates per thread, which keeps
+// loading millions of transactions cheap
+bool parseDate(const char* str, size_t length, std::time_t& time) {
+    static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    size_t i = 0;
+    while (i < length && str[i] == ' ') ++i;
+    if (i + 8 > length || str[i + 3] != ' ') return false;
+    i += 4; // Weekday name
+
+    while (i < length && str[i] == ' ') ++i;
+    if (i + 3 > length) return false;
+    int month = -1;
+    for (int m = 0; m < 12; ++m) {
+        if (std::memcmp(str + i, MONTHS + m * 3, 3) == 0) {
+            month = m;
+            break;
+        }
+    }
+    if (month < 0) return false;
+    i += 3;
+
+    int day, hour, minute, second, year;
+    if (!readNumber(str, length, i, day)) return false;
+    if (!readNumber(str, length, i, hour) || i >= length || str[i++] != ':') return false;
+    if (!readNumber(str, length, i, minute) || i >= length || str[i++] != ':') return false;
+    if (!readNumber(str, length, i, second)) return false;
+    if (!readNumber(str, length, i, year)) return false;
+    while (i < length && str[i] == ' ') ++i;
+    if (i != length || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+
+    struct HourCache {
+        int year, month, day, hour;
+        std::time_t start;
+    };
+    static thread_local HourCache cache = {-1, -1, -1, -1, 0};
+
+    if (cache.year != year || cache.month != month || cache.day != day || cache.hour != hour) {
+        std::tm parts;
+        std::memset(&parts, 0, sizeof(parts));
+        parts.tm_year = year - 1900;
+        parts.tm_mon = month;
+        parts.tm_mday = day;
+        parts.tm_hour = hour;
+        parts.tm_isdst = -1;
+        std::time_t start = std::mktime(&parts);
+        if (start == static_cast<std::time_t>(-1)) return false;
+
+        cache.year = year;
+        cache.month = month;
+        cache.day = day;
+        cache.hour = hour;
+        cache.start = start;
+    }
+
+    time = cache.start + minute * 60 + second;
+    return true;
+}
+
+namespace {
+
+// Standard CRC-32 (IEEE 802.3) lookup tables for slicing-by-8:
+// entries[k][b] is the CRC of byte b followed by k zero bytes
+struct Crc32Table {
+    uint32_t entries[8][256];
+
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                entries[k][i] = (entries[k - 1][i] >> 8) ^ entries[0][entries[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+} // namespace
+
+// Helper function: CRC-32 checksum used by the journal and snapshot files
+// Processes 8 bytes per step, which keeps checksumming multi-GB snapshots cheap
+uint32_t crc32(const char* data, size_t length) {
+    static const Crc32Table table;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    uint32_t crc = 0xFFFFFFFFu;
+    while (length >= 8) {
+        uint32_t low = crc ^ (static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+                              static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24);
+        crc = table.entries[7][low & 0xFF] ^ table.entries[6][(low >> 8) & 0xFF] ^
+              table.entries[5][(low >> 16) & 0xFF] ^ table.entries[4][low >> 24] ^
+              table.entries[3][bytes[4]] ^ table.entries[2][bytes[5]] ^
+              table.entries[1][bytes[6]] ^ table.entries[0][bytes[7]];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = table.entries[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Helper function: Crash-safe file replacement
+// Readers see either the old file or the complete new one, never a partial write
+bool writeFileAtomically(const std::string& path, const std::string& contents) {
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error creating " << tempPath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    const char* data = contents.data();
+    size_t remaining = contents.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error writing " << tempPath << ": " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    bool ok = (::fsync(fd) == 0);
+    ::close(fd);
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error replacing " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return syncParentDirectory(path);
+}
+
+// Helper function: Appends and syncs in one go, for files that only ever grow
+bool appendFileSynced(const std::string& path, const char* data, size_t size) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Error opening " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    bool ok = (size == 0 && ::fsync(fd) == 0);
+    if (!ok) {
+        std::cerr << "Error appending to " << path << ": " << std::strerror(errno) << std::endl;
+    }
+    ::close(fd);
+    return ok;
+}
+
+// Helper function: fsync of the directory holding path, so a rename survives a crash
+bool syncParentDirectory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string directory = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening " << directory << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    bool ok = (::fsync(fd) == 0);
+    ::close(fd);
+    if (!ok) {
+        std::cerr << "Error syncing " << directory << ": " << std::strerror(errno) << std::endl;
+    }
+    return ok;
+}
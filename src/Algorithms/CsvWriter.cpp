@@ -0,0 +1,124 @@
+#include "../../include/utils/CsvWriter.h"
+#include "../../include/utils/Algorithms.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+CsvWriter::CsvWriter() : used(0), fd(-1), replacing(false), failed(false) {}
+
+CsvWriter::~CsvWriter() {
+    if (fd < 0) return;
+    ::close(fd);
+    if (replacing) ::unlink((path + ".tmp").c_str());
+}
+
+bool CsvWriter::open(const std::string& filePath) {
+    path = filePath;
+    std::string tempPath = path + ".tmp";
+    fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error creating " << tempPath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    replacing = true;
+    failed = false;
+    used = 0;
+    buffer.resize(BUFFER_SIZE);
+    return true;
+}
+
+bool CsvWriter::openForAppend(const std::string& filePath) {
+    path = filePath;
+    fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Error opening " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    replacing = false;
+    failed = false;
+    used = 0;
+    buffer.resize(BUFFER_SIZE);
+    return true;
+}
+
+void CsvWriter::makeRoom(size_t size) {
+    if (fd >= 0) flush();
+    if (used + size <= buffer.size()) return;
+
+    // In memory (or a single piece larger than the buffer): grow instead
+    size_t capacity = buffer.size() < 128 ? 128 : buffer.size() * 2;
+    if (capacity < used + size) capacity = used + size;
+    buffer.resize(capacity);
+}
+
+void CsvWriter::flush() {
+    const char* data = buffer.data();
+    size_t remaining = used;
+    while (remaining > 0 && !failed) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error writing " << path << ": " << std::strerror(errno) << std::endl;
+            failed = true;
+            break;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    used = 0;
+}
+
+bool CsvWriter::commit() {
+    if (fd < 0) return false;
+    flush();
+    bool ok = !failed && ::fsync(fd) == 0;
+    ::close(fd);
+    fd = -1;
+
+    if (replacing) {
+        std::string tempPath = path + ".tmp";
+        if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "Error replacing " << path << ": " << std::strerror(errno) << std::endl;
+            ::unlink(tempPath.c_str());
+            return false;
+        }
+        return syncParentDirectory(path);
+    }
+    if (!ok) {
+        std::cerr << "Error appending to " << path << ": " << std::strerror(errno) << std::endl;
+    }
+    return ok;
+}
+
+void CsvWriter::put(const char* data, size_t size) {
+    if (size == 0) return;
+    std::memcpy(reserve(size), data, size);
+    used += size;
+}
+
+void CsvWriter::putInteger(int64_t value) {
+    uint64_t magnitude = (value < 0) ? 0ull - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+
+    // Digits are produced backwards into a scratch buffer
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    char* out = reserve(count + 1);
+    size_t length = 0;
+    if (value < 0) out[length++] = '-';
+    while (count > 0) {
+        out[length++] = digits[--count];
+    }
+    used += length;
+}
+
+std::string CsvWriter::str() const {
+    return std::string(buffer.data(), used);
+}
@@ -2,12 +2,249 @@
 #include "../../include/utils/Algorithms.h"
 #include "../../include/System details/CheckingAccount.h"
 #include "../../include/System details/SavingsAccount.h"
+#include "../../include/utils/MappedFile.h"
+#include "../../include/utils/CsvWriter.h"
 #include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/stat.h>
+
+namespace {
+
+// Calls handle(lineBegin, lineEnd) for every non-empty line, without the line terminator
+template<typename Handler>
+void forEachLine(const char* data, size_t size, Handler handle) {
+    const char* cursor = data;
+    const char* end = data + size;
+
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        if (lineEnd == nullptr) lineEnd = end;
+
+        const char* contentEnd = lineEnd;
+        if (contentEnd > cursor && contentEnd[-1] == '\r') --contentEnd;
+        if (contentEnd > cursor) handle(cursor, contentEnd);
+
+        cursor = lineEnd + 1;
+    }
+}
+
+size_t countLines(const char* data, size_t size) {
+    size_t lines = 0;
+    const char* cursor = data;
+    const char* end = data + size;
+    while ((cursor = static_cast<const char*>(
+                std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)))) != nullptr) {
+        ++lines;
+        ++cursor;
+    }
+    return lines + 1;
+}
+
+// Integer parse straight to cents; older files wrote six decimals, which round half-even
+Money parseMoney(const char* text, size_t length) {
+    Money amount;
+    if (Money::parse(text, length, amount)) return amount;
+    return Money::fromDouble(std::stod(std::string(text, length))); // Fallback for exponents and unusual formats
+}
+
+InterestRate parseRate(const char* text, size_t length) {
+    InterestRate rate;
+    if (InterestRate::parse(text, length, rate)) return rate;
+    return InterestRate::fromDouble(std::stod(std::string(text, length)));
+}
+
+// Savings rows end with the accrued-through time and carry; older files stop at the rate
+// (accrual then starts from the load time)
+void parseAccrual(const char* timeText, size_t timeLength, const char* carryText, size_t carryLength,
+                  std::time_t& accruedThrough, int64_t& carry) {
+    accruedThrough = static_cast<std::time_t>(std::stoll(std::string(timeText, timeLength)));
+    carry = std::stoll(std::string(carryText, carryLength));
+}
+
+// Builds a transaction from the five CSV fields; the date runs to the end of the line
+void parseTransactionRow(const FieldView* parts, const char* lineEnd, Transaction& trans) {
+    TransactionId id = TransactionId::fromString(parts[0].data, parts[0].size);
+    AccountId accountId = AccountId::fromString(parts[1].data, parts[1].size);
+    Transaction::Type type;
+    std::time_t time;
+
+    if (!id.isValid()) throw std::invalid_argument("bad transaction ID " + parts[0].str());
+    if (!accountId.isValid()) throw std::invalid_argument("bad account ID " + parts[1].str());
+    if (!Transaction::parseType(parts[2].data, parts[2].size, type)) {
+        throw std::invalid_argument("bad transaction type " + parts[2].str());
+    }
+    if (!parseDate(parts[4].data, static_cast<size_t>(lineEnd - parts[4].data), time)) {
+        throw std::invalid_argument("bad date " + std::string(parts[4].data, lineEnd));
+    }
+    trans = Transaction(id, accountId, type, parseMoney(parts[3].data, parts[3].size), time);
+}
+
+// Creates the account described by a row's fields (at least five) in pool
+Account* parseAccountRow(const FieldView* parts, size_t count, AccountPool& pool) {
+    std::string id = parts[0].str();
+    Money balance = parseMoney(parts[3].data, parts[3].size);
+
+    if (parts[2].equals("Checking") && count >= 6) {
+        return pool.create<CheckingAccount>(id, parts[1].str(), balance, parts[4].str(),
+                                            parseMoney(parts[5].data, parts[5].size));
+    }
+    if (parts[2].equals("Savings") && count >= 6) {
+        std::time_t accruedThrough = 0;
+        int64_t carry = 0;
+        if (count >= 8) {
+            parseAccrual(parts[6].data, parts[6].size, parts[7].data, parts[7].size, accruedThrough, carry);
+        }
+        return pool.create<SavingsAccount>(id, parts[1].str(), balance, parts[4].str(),
+                                           parseRate(parts[5].data, parts[5].size), accruedThrough, carry);
+    }
+    // For any other account type, create a base Account
+    return pool.create<Account>(id, parts[1].str(), parts[2].str(), balance, parts[4].str());
+}
+
+const char CHANGE_BASE_TAG[] = "#base,";
+const size_t CHANGE_BASE_TAG_LENGTH = sizeof(CHANGE_BASE_TAG) - 1;
+const char CHANGE_COVERS_TAG[] = "#covers,";
+const size_t CHANGE_COVERS_TAG_LENGTH = sizeof(CHANGE_COVERS_TAG) - 1;
+
+} // namespace
 
 FileHandler::FileHandler(const std::string& accFile, const std::string& transFile)
-    : accountsFilePath(accFile), transactionsFilePath(transFile) {}
+    : accountsFilePath(accFile), transactionsFilePath(transFile), loadThreads(0), accountChangeRows(0) {}
+
+void FileHandler::loadAccounts(std::vector<Account*>& accounts, AccountPool& pool) {
+    if (!loadAccountsMapped(accounts, pool)) {
+        loadAccountsStream(accounts, pool);
+    }
+}
+
+void FileHandler::loadTransactions(std::vector<Transaction>& transactions) {
+    if (!loadTransactionsMapped(transactions)) {
+        loadTransactionsStream(transactions);
+    }
+}
+
+bool FileHandler::loadAccountsMapped(std::vector<Account*>& accounts, AccountPool& pool) {
+    MappedFile file;
+    if (!file.open(accountsFilePath)) return false;
+
+    forEachLine(file.data(), file.size(), [&](const char* begin, const char* end) {
+        FieldView parts[8];
+        size_t count = splitFields(begin, end, ',', parts, 8);
+        if (count < 5) return;
+
+        try {
+            accounts.push_back(parseAccountRow(parts, count, pool));
+        } catch (const std::exception& e) {
+            std::cerr << "Error loading account data: " << e.what() << std::endl;
+        }
+    });
+    return true;
+}
+
+bool FileHandler::loadTransactionsMapped(std::vector<Transaction>& transactions) {
+    MappedFile file;
+    if (!file.open(transactionsFilePath)) return false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    unsigned threads = loadThreads;
+    if (threads == 0) {
+        // Auto mode: small files aren't worth the thread start-up cost
+        threads = (file.size() >= PARALLEL_LOAD_MIN_BYTES) ? std::thread::hardware_concurrency() : 1;
+    }
+    if (threads < 1) threads = 1;
+
+    size_t before = transactions.size();
+    if (threads == 1) {
+        parseTransactionChunk(file.data(), file.data() + file.size(), transactions);
+    } else {
+        loadTransactionsParallel(file.data(), file.size(), threads, transactions);
+    }
+
+    lastLoadStats.rows = transactions.size() - before;
+    lastLoadStats.threads = threads;
+    lastLoadStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (threads > 1) {
+        std::cout << "Loaded " << lastLoadStats.rows << " transactions with " << threads << " threads ("
+                  << static_cast<long long>(lastLoadStats.rowsPerSecond()) << " rows/sec)" << std::endl;
+    }
+    return true;
+}
+
+/**
+ * Splits the mapped file into newline-aligned chunks, parses each chunk on its
+ * own thread into a private buffer, then moves the buffers into transactions
+ * in file order. Threads share nothing while parsing, so throughput scales
+ * with the number of cores.
+ */
+void FileHandler::loadTransactionsParallel(const char* data, size_t size, unsigned threads,
+                                           std::vector<Transaction>& transactions) {
+    std::vector<const char*> bounds;
+    bounds.push_back(data);
+    for (unsigned i = 1; i < threads; ++i) {
+        const char* cut = data + (size * i) / threads;
+        if (cut < bounds.back()) cut = bounds.back();
+        const char* newline = static_cast<const char*>(
+            std::memchr(cut, '\n', static_cast<size_t>(data + size - cut)));
+        bounds.push_back(newline ? newline + 1 : data + size);
+    }
+    bounds.push_back(data + size);
+
+    std::vector<std::vector<Transaction> > buffers(threads);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.push_back(std::thread([&bounds, &buffers, i]() {
+            parseTransactionChunk(bounds[i], bounds[i + 1], buffers[i]);
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    size_t total = transactions.size();
+    for (const auto& buffer : buffers) {
+        total += buffer.size();
+    }
+    transactions.reserve(total);
+    for (auto& buffer : buffers) {
+        std::move(buffer.begin(), buffer.end(), std::back_inserter(transactions));
+        std::vector<Transaction>().swap(buffer);
+    }
+}
+
+void FileHandler::parseTransactionChunk(const char* begin, const char* end,
+                                        std::vector<Transaction>& transactions) {
+    transactions.reserve(transactions.size() + countLines(begin, static_cast<size_t>(end - begin)));
 
-void FileHandler::loadAccounts(std::map<std::string, Account*>& accounts) {
+    forEachLine(begin, static_cast<size_t>(end - begin), [&](const char* lineBegin, const char* lineEnd) {
+        FieldView parts[5];
+        if (splitFields(lineBegin, lineEnd, ',', parts, 5) < 5) return;
+
+        try {
+            Transaction trans;
+            parseTransactionRow(parts, lineEnd, trans);
+            transactions.push_back(trans);
+        } catch (const std::exception& e) {
+            std::cerr << "Error loading transaction data: " << e.what() << std::endl;
+        }
+    });
+}
+
+void FileHandler::setLoadThreads(unsigned threads) {
+    loadThreads = threads;
+}
+
+FileHandler::LoadStats FileHandler::getLastLoadStats() const {
+    return lastLoadStats;
+}
+
+void FileHandler::loadAccountsStream(std::vector<Account*>& accounts, AccountPool& pool) {
     std::ifstream accountsFile(accountsFilePath);
     if (accountsFile.is_open()) {
         std::string line;
@@ -21,18 +258,25 @@ void FileHandler::loadAccounts(std::map<std::string, Account*>& accounts) {
                     std::string id = parts[0];
                     std::string name = parts[1];
                     std::string type = parts[2];
-                    double balance = std::stod(parts[3]);
+                    Money balance = parseMoney(parts[3].data(), parts[3].size());
                     std::string password = parts[4];
                     
                     if (type == "Checking" && parts.size() >= 6) {
-                        double fee = std::stod(parts[5]);
-                        accounts[id] = new CheckingAccount(id, name, balance, password, fee);
+                        Money fee = parseMoney(parts[5].data(), parts[5].size());
+                        accounts.push_back(pool.create<CheckingAccount>(id, name, balance, password, fee));
                     } else if (type == "Savings" && parts.size() >= 6) {
-                        double rate = std::stod(parts[5]);
-                        accounts[id] = new SavingsAccount(id, name, balance, password, rate);
+                        InterestRate rate = parseRate(parts[5].data(), parts[5].size());
+                        std::time_t accruedThrough = 0;
+                        int64_t carry = 0;
+                        if (parts.size() >= 8) {
+                            parseAccrual(parts[6].data(), parts[6].size(), parts[7].data(), parts[7].size(),
+                                         accruedThrough, carry);
+                        }
+                        accounts.push_back(pool.create<SavingsAccount>(id, name, balance, password, rate,
+                                                                       accruedThrough, carry));
                     } else {
                         // For any other account type, create a base Account
-                        accounts[id] = new Account(id, name, type, balance, password);
+                        accounts.push_back(pool.create<Account>(id, name, type, balance, password));
                     }
                 }
             } catch (const std::exception& e) {
@@ -45,45 +289,174 @@ void FileHandler::loadAccounts(std::map<std::string, Account*>& accounts) {
     }
 }
 
-void FileHandler::loadTransactions(std::vector<Transaction>& transactions) {
+void FileHandler::loadTransactionsStream(std::vector<Transaction>& transactions) {
     std::ifstream transactionsFile(transactionsFilePath);
     if (transactionsFile.is_open()) {
         std::string line;
         while (std::getline(transactionsFile, line)) {
             if (line.empty()) continue;
             
-            std::vector<std::string> parts = splitString(line, ',');
+            if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+            FieldView parts[5];
+            const char* lineEnd = line.data() + line.size();
             
-            if (parts.size() >= 5) {
-                std::string transId = parts[0];
-                std::string accId = parts[1];
-                std::string type = parts[2];
-                double amount = std::stod(parts[3]);
-                std::string date = parts[4];
-                
-                transactions.push_back(Transaction(transId, accId, type, amount, date));
+            if (splitFields(line.data(), lineEnd, ',', parts, 5) >= 5) {
+                try {
+                    Transaction trans;
+                    parseTransactionRow(parts, lineEnd, trans);
+                    transactions.push_back(trans);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error loading transaction data: " << e.what() << std::endl;
+                }
             }
         }
         transactionsFile.close();
     }
 }
 
-void FileHandler::saveAccounts(const std::map<std::string, Account*>& accounts) {
-    std::ofstream accountsFile(accountsFilePath);
-    if (accountsFile.is_open()) {
-        for (const auto& pair : accounts) {
-            accountsFile << pair.second->toCSV() << std::endl;
-        }
-        accountsFile.close();
+bool FileHandler::saveAccounts(const std::vector<Account*>& accounts) {
+    CsvWriter out;
+    if (!out.open(accountsFilePath)) return false;
+    for (const Account* acc : accounts) {
+        acc->writeCSV(out);
+        out.endRow();
     }
+    return out.commit();
 }
 
 void FileHandler::saveTransactions(const std::vector<Transaction>& transactions) {
-    std::ofstream transactionsFile(transactionsFilePath);
-    if (transactionsFile.is_open()) {
-        for (const auto& trans : transactions) {
-            transactionsFile << trans.toCSV() << std::endl;
+    CsvWriter out;
+    if (!out.open(transactionsFilePath)) return;
+    for (const auto& trans : transactions) {
+        trans.writeCSV(out);
+        out.endRow();
+    }
+    out.commit();
+}
+
+// Appends transactions[first..] to the transactions file instead of rewriting the history
+bool FileHandler::appendTransactions(const std::vector<Transaction>& transactions, size_t first) {
+    if (first >= transactions.size()) return true;
+
+    CsvWriter out;
+    if (!out.openForAppend(transactionsFilePath)) return false;
+    for (size_t i = first; i < transactions.size(); ++i) {
+        transactions[i].writeCSV(out);
+        out.endRow();
+    }
+    return out.commit();
+}
+
+std::string FileHandler::getAccountChangesPath() const {
+    return accountsFilePath + ".delta";
+}
+
+size_t FileHandler::getAccountChangeCount() const {
+    return accountChangeRows;
+}
+
+// Called once the transactions file is complete, so the base records the file as it stands
+FileHandler::ChangeBase FileHandler::getChangeBase(size_t transactionRows, uint64_t journalSegment) const {
+    struct stat info;
+    ChangeBase base;
+    base.transactionRows = transactionRows;
+    base.transactionBytes = (::stat(transactionsFilePath.c_str(), &info) == 0) ? static_cast<uint64_t>(info.st_size) : 0;
+    base.journalSegment = journalSegment;
+    return base;
+}
+
+bool FileHandler::startAccountChanges(const ChangeBase& base) {
+    std::string header = CHANGE_BASE_TAG;
+    header += std::to_string(static_cast<unsigned long long>(base.transactionRows));
+    header += ',';
+    header += std::to_string(static_cast<unsigned long long>(base.transactionBytes));
+    header += ',';
+    header += std::to_string(static_cast<unsigned long long>(base.journalSegment));
+    header += '\n';
+    if (!writeFileAtomically(getAccountChangesPath(), header)) return false;
+    accountChangeRows = 0;
+    return true;
+}
+
+bool FileHandler::appendAccountChanges(const std::vector<const Account*>& changed,
+                                       const std::vector<AccountId>& closed, uint64_t coveredSegment) {
+    if (changed.empty() && closed.empty() && coveredSegment == 0) return true;
+
+    CsvWriter out;
+    if (!out.openForAppend(getAccountChangesPath())) return false;
+    for (const Account* acc : changed) {
+        acc->writeCSV(out);
+        out.endRow();
+    }
+    for (AccountId id : closed) {
+        out.put('-');
+        out.putFormatted(id);
+        out.endRow();
+    }
+    if (coveredSegment != 0) {
+        // Last, so a torn append never claims rows that aren't there
+        out.put(CHANGE_COVERS_TAG, CHANGE_COVERS_TAG_LENGTH);
+        out.putInteger(static_cast<int64_t>(coveredSegment));
+        out.endRow();
+    }
+    if (!out.commit()) return false;
+    accountChangeRows += changed.size() + closed.size();
+    return true;
+}
+
+bool FileHandler::loadAccountChanges(std::vector<Account*>& accounts, std::vector<AccountId>& closed,
+                                     AccountPool& pool, ChangeBase& base, uint64_t& coveredSegment) {
+    accountChangeRows = 0;
+    MappedFile file;
+    if (!file.open(getAccountChangesPath())) return false;
+
+    bool firstRow = true;
+    bool headerSeen = false;
+    forEachLine(file.data(), file.size(), [&](const char* begin, const char* end) {
+        if (firstRow) {
+            firstRow = false;
+            // Without its base row the segment can't be placed, so none of it is used
+            FieldView parts[4];
+            size_t length = static_cast<size_t>(end - begin);
+            size_t count = 0;
+            if (length > CHANGE_BASE_TAG_LENGTH && std::memcmp(begin, CHANGE_BASE_TAG, CHANGE_BASE_TAG_LENGTH) == 0) {
+                count = splitFields(begin, end, ',', parts, 4);
+            }
+            if (count >= 3) {
+                base.transactionRows = std::strtoull(parts[1].str().c_str(), nullptr, 10);
+                base.transactionBytes = std::strtoull(parts[2].str().c_str(), nullptr, 10);
+                // Segments started before snapshots were numbered have no segment field
+                if (count == 4) base.journalSegment = std::strtoull(parts[3].str().c_str(), nullptr, 10);
+                coveredSegment = base.journalSegment;
+                headerSeen = true;
+            }
+            return;
         }
-        transactionsFile.close();
+        if (!headerSeen) return;
+
+        size_t length = static_cast<size_t>(end - begin);
+        if (length > CHANGE_COVERS_TAG_LENGTH && std::memcmp(begin, CHANGE_COVERS_TAG, CHANGE_COVERS_TAG_LENGTH) == 0) {
+            coveredSegment = std::strtoull(std::string(begin + CHANGE_COVERS_TAG_LENGTH, end).c_str(), nullptr, 10);
+            return;
+        }
+
+        ++accountChangeRows;
+        if (*begin == '-') {
+            AccountId id = AccountId::fromString(begin + 1, static_cast<size_t>(end - begin - 1));
+            if (id.isValid()) closed.push_back(id);
+            return;
+        }
+        FieldView parts[8];
+        size_t count = splitFields(begin, end, ',', parts, 8);
+        if (count < 5) return;
+        try {
+            accounts.push_back(parseAccountRow(parts, count, pool));
+        } catch (const std::exception& e) {
+            std::cerr << "Error loading account changes: " << e.what() << std::endl;
+        }
+    });
+    if (!headerSeen) {
+        std::cerr << "Ignoring " << getAccountChangesPath() << ": no base row" << std::endl;
     }
-}
\ No newline at end of file
+    return headerSeen;
+}
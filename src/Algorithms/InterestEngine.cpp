@@ -0,0 +1,218 @@
+#include "../../include/utils/InterestEngine.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace {
+
+/**
+ * Worker threads shared by every sweep of the process. They are started on
+ * the first parallel sweep that needs them and then wait for the next one, so
+ * a sweep costs a wake-up per worker instead of a thread start and join.
+ * Part 0 of each sweep runs on the calling thread; one sweep at a time.
+ */
+class SweepPool {
+public:
+    static SweepPool& instance() {
+        static SweepPool pool;
+        return pool;
+    }
+
+    // Runs task(0) .. task(parts - 1) and returns once they have all finished
+    void run(unsigned parts, const std::function<void(unsigned)>& task) {
+        std::lock_guard<std::mutex> sweep(runMutex);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (workers.size() + 1 < parts) {
+            workers.push_back(std::thread(&SweepPool::work, this, generation));
+        }
+        current = &task;
+        partCount = parts;
+        nextPart = 1;
+        unfinished = parts - 1;
+        ++generation;
+        wake.notify_all();
+
+        lock.unlock();
+        task(0);
+        lock.lock();
+        runParts(lock);   // Whatever the workers haven't picked up yet
+        while (unfinished > 0) {
+            finished.wait(lock);
+        }
+        current = nullptr;
+    }
+
+    ~SweepPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+private:
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::vector<std::thread> workers;
+    const std::function<void(unsigned)>* current;
+    unsigned partCount;
+    unsigned nextPart;
+    unsigned unfinished;
+    uint64_t generation;
+    bool stopping;
+
+    SweepPool() : current(nullptr), partCount(0), nextPart(0), unfinished(0), generation(0), stopping(false) {}
+
+    // Runs unclaimed parts of the current sweep (mutex held)
+    void runParts(std::unique_lock<std::mutex>& lock) {
+        while (nextPart < partCount) {
+            unsigned part = nextPart++;
+            lock.unlock();
+            (*current)(part);
+            lock.lock();
+            if (--unfinished == 0) finished.notify_one();
+        }
+    }
+
+    // seen: the sweep before the first one this worker may join
+    void work(uint64_t seen) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            while (!stopping && generation == seen) {
+                wake.wait(lock);
+            }
+            if (stopping) return;
+            seen = generation;
+            runParts(lock);   // Workers beyond this sweep's part count find nothing left
+        }
+    }
+};
+
+} // namespace
+
+InterestEngine::InterestEngine(std::time_t asOf, unsigned threads)
+    : asOf(asOf), threads(threads), cachedRateMicros(-1), cachedDays(-1), cachedGrowth(0) {}
+
+void InterestEngine::reserve(size_t count) {
+    accounts.reserve(count);
+    days.reserve(count);
+    balanceCents.reserve(count);
+    growth.reserve(count);
+    carry.reserve(count);
+}
+
+void InterestEngine::add(SavingsAccount* account) {
+    int64_t elapsed = account->accrualDays(asOf);
+    if (elapsed <= 0) return;
+
+    int64_t balance = account->getBalance().getCents();
+    int64_t factor = 0;
+    if (balance > 0) {
+        int64_t rate = account->getInterestRate().getMicros();
+        if (rate != cachedRateMicros || elapsed != cachedDays) {
+            cachedRateMicros = rate;
+            cachedDays = elapsed;
+            cachedGrowth = SavingsAccount::growthFor(account->getInterestRate(), elapsed);
+        }
+        factor = cachedGrowth;
+    } else {
+        balance = 0;
+    }
+
+    int64_t product;
+    if (__builtin_mul_overflow(balance, factor, &product)) {
+        // Keeps the kernel free of overflow checks
+        wideAccounts.push_back(account);
+        return;
+    }
+    accounts.push_back(account);
+    days.push_back(elapsed);
+    balanceCents.push_back(balance);
+    growth.push_back(factor);
+    carry.push_back(account->getAccrualCarry());
+}
+
+void InterestEngine::clear() {
+    accounts.clear();
+    days.clear();
+    balanceCents.clear();
+    growth.clear();
+    carry.clear();
+    interestCents.clear();
+    wideAccounts.clear();
+}
+
+size_t InterestEngine::size() const {
+    return accounts.size() + wideAccounts.size();
+}
+
+/**
+ * Straight-line integer code over plain arrays (no calls, no branches); the
+ * divisions by the constant scales compile to a multiply-high and a shift.
+ * It stays scalar: x86 has no 64-bit vector multiply below AVX-512DQ and no
+ * 64-bit vector multiply-high at all (-fopt-info-vec: "couldn't vectorize").
+ * Balances are never negative here, so truncation matches
+ * SavingsAccount::accrueInterest().
+ */
+void InterestEngine::computeAccrual(const int64_t* balanceCents, const int64_t* growth,
+                                    int64_t* carry, int64_t* interestCents, size_t count) {
+    const int64_t carryPerGrowth = SavingsAccount::GROWTH_SCALE / SavingsAccount::CARRY_SCALE;
+    const int64_t carryScale = SavingsAccount::CARRY_SCALE;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t total = balanceCents[i] * growth[i] / carryPerGrowth + carry[i];
+        int64_t whole = total / carryScale;
+        interestCents[i] = whole;
+        carry[i] = total - whole * carryScale;
+    }
+}
+
+void InterestEngine::run(std::vector<Accrual>& accruals) {
+    size_t count = accounts.size();
+    interestCents.resize(count);
+
+    unsigned workers = threads;
+    if (workers == 0) {
+        // Auto mode: small sweeps aren't worth waking the workers
+        workers = (count >= PARALLEL_MIN_ACCOUNTS) ? std::thread::hardware_concurrency() : 1;
+    }
+    if (workers < 1) workers = 1;
+    if (workers > count) workers = count > 0 ? static_cast<unsigned>(count) : 1;
+
+    // Each worker computes and books its own contiguous range; results land in place
+    accruals.reserve(accruals.size() + count + wideAccounts.size());
+    size_t first = accruals.size();
+    accruals.resize(first + count);
+    auto sweep = [&](unsigned worker) {
+        size_t begin = count * worker / workers;
+        size_t end = count * (worker + 1) / workers;
+        computeAccrual(balanceCents.data() + begin, growth.data() + begin, carry.data() + begin,
+                       interestCents.data() + begin, end - begin);
+
+        for (size_t i = begin; i < end; ++i) {
+            Accrual& accrual = accruals[first + i];
+            accrual.account = accounts[i];
+            accounts[i]->settleAccrual(days[i], interestCents[i], carry[i], accrual.interest);
+        }
+    };
+
+    if (workers == 1 || count == 0) {
+        sweep(0);
+    } else {
+        SweepPool::instance().run(workers, sweep);
+    }
+
+    // Rare balances too large for the kernel go through the 128-bit path
+    for (SavingsAccount* account : wideAccounts) {
+        Accrual accrual;
+        accrual.account = account;
+        if (account->accrueInterest(asOf, accrual.interest)) {
+            accruals.push_back(accrual);
+        }
+    }
+}
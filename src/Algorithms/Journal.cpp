@@ -0,0 +1,578 @@
+#include "../../include/utils/Journal.h"
+#include "../../include/utils/Algorithms.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <cstdio>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+const size_t MAGIC_SIZE = 8;
+const char JOURNAL_MAGIC[MAGIC_SIZE] = {'B', 'A', 'N', 'K', 'J', 'R', 'N', 'L'};
+const size_t HEADER_SIZE = MAGIC_SIZE + sizeof(uint64_t);   // Magic, then the segment number
+
+template<typename T>
+void putValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void putString(std::string& out, const std::string& value) {
+    putValue<uint16_t>(out, static_cast<uint16_t>(value.size()));
+    out.append(value);
+}
+
+// Cursor over a record payload; every read is bounds-checked
+struct Reader {
+    const char* data;
+    size_t size;
+    size_t offset;
+    bool ok;
+
+    template<typename T>
+    T get() {
+        T value = T();
+        if (offset + sizeof(T) > size) { ok = false; return value; }
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        uint16_t length = get<uint16_t>();
+        if (!ok || offset + length > size) { ok = false; return std::string(); }
+        std::string value(data + offset, length);
+        offset += length;
+        return value;
+    }
+};
+
+// Appends the framed record to out; the frame header is patched in once the payload is known
+void encodeInto(std::string& out, const Journal::Record& record) {
+    size_t frameStart = out.size();
+    out.append(8, '\0');
+    putValue<uint8_t>(out, record.type);
+    putString(out, record.accountId);
+
+    switch (record.type) {
+        case Journal::CREATE_ACCOUNT:
+            putString(out, record.customerName);
+            putString(out, record.accountType);
+            putString(out, record.password);
+            // One parameter slot: fee cents for Checking, rate millionths for Savings
+            putValue<int64_t>(out, record.accountType == "Savings" ? record.interestRate.getMicros()
+                                                                   : record.transactionFee.getCents());
+            putValue<int64_t>(out, record.balance.getCents());
+            putValue<int64_t>(out, record.timestamp);
+            break;
+        case Journal::DEPOSIT:
+        case Journal::WITHDRAWAL:
+            putValue<uint64_t>(out, record.transactionId.getValue());
+            putValue<int64_t>(out, record.amount.getCents());
+            putValue<int64_t>(out, record.timestamp);
+            putValue<int64_t>(out, record.balance.getCents());
+            break;
+        case Journal::INTEREST_ACCRUED:
+            putValue<uint64_t>(out, record.transactionId.getValue());
+            putValue<int64_t>(out, record.amount.getCents());
+            putValue<int64_t>(out, record.timestamp);
+            putValue<int64_t>(out, record.balance.getCents());
+            putValue<int64_t>(out, record.accrualCarry);
+            break;
+        case Journal::CLOSE_ACCOUNT:
+            break;
+    }
+
+    uint32_t length = static_cast<uint32_t>(out.size() - frameStart - 8);
+    uint32_t checksum = crc32(out.data() + frameStart + 8, length);
+    std::memcpy(&out[frameStart], &length, sizeof(length));
+    std::memcpy(&out[frameStart + 4], &checksum, sizeof(checksum));
+}
+
+std::string encode(const Journal::Record& record) {
+    std::string frame;
+    encodeInto(frame, record);
+    return frame;
+}
+
+bool decode(const char* data, size_t size, Journal::Record& record) {
+    Reader reader = {data, size, 0, true};
+    record = Journal::Record();
+    record.type = static_cast<Journal::RecordType>(reader.get<uint8_t>());
+    record.accountId = reader.getString();
+
+    switch (record.type) {
+        case Journal::CREATE_ACCOUNT:
+            record.customerName = reader.getString();
+            record.accountType = reader.getString();
+            record.password = reader.getString();
+            {
+                int64_t param = reader.get<int64_t>();
+                record.transactionFee = Money::fromCents(param);
+                record.interestRate = InterestRate::fromMicros(param);
+            }
+            record.balance = Money::fromCents(reader.get<int64_t>());
+            record.timestamp = reader.get<int64_t>();
+            break;
+        case Journal::DEPOSIT:
+        case Journal::WITHDRAWAL:
+            record.transactionId = TransactionId(reader.get<uint64_t>());
+            record.amount = Money::fromCents(reader.get<int64_t>());
+            record.timestamp = reader.get<int64_t>();
+            record.balance = Money::fromCents(reader.get<int64_t>());
+            break;
+        case Journal::INTEREST_ACCRUED:
+            record.transactionId = TransactionId(reader.get<uint64_t>());
+            record.amount = Money::fromCents(reader.get<int64_t>());
+            record.timestamp = reader.get<int64_t>();
+            record.balance = Money::fromCents(reader.get<int64_t>());
+            record.accrualCarry = reader.get<int64_t>();
+            break;
+        case Journal::CLOSE_ACCOUNT:
+            break;
+        default:
+            return false;
+    }
+    return reader.ok;
+}
+
+// Whole file into contents; false if it can't be opened (e.g. it doesn't exist)
+bool readFile(const std::string& path, std::vector<char>& contents) {
+    int readFd = ::open(path.c_str(), O_RDONLY);
+    if (readFd < 0) return false;
+
+    char chunk[65536];
+    ssize_t n;
+    while ((n = ::read(readFd, chunk, sizeof(chunk))) > 0) {
+        contents.insert(contents.end(), chunk, chunk + n);
+    }
+    ::close(readFd);
+    return true;
+}
+
+// Whether contents starts with a journal header
+bool isJournal(const std::vector<char>& contents) {
+    return contents.size() >= HEADER_SIZE && std::memcmp(contents.data(), JOURNAL_MAGIC, MAGIC_SIZE) == 0;
+}
+
+// Moves a file that isn't a journal out of the way (path + ".old") instead of appending to it
+void setAside(const std::string& path) {
+    std::string oldPath = path + ".old";
+    std::cerr << "Journal " << path << " is not in the current format; moved to " << oldPath
+              << " and not replayed" << std::endl;
+    if (std::rename(path.c_str(), oldPath.c_str()) != 0) {
+        std::cerr << "Error moving " << path << ": " << std::strerror(errno) << std::endl;
+    }
+}
+
+// Header of a current-format journal file
+std::string journalHeader(uint64_t segment) {
+    std::string header(JOURNAL_MAGIC, MAGIC_SIZE);
+    putValue<uint64_t>(header, segment);
+    return header;
+}
+
+// Segment number from the header of a journal file
+uint64_t journalSegment(const std::vector<char>& contents) {
+    uint64_t segment = 0;
+    std::memcpy(&segment, &contents[MAGIC_SIZE], sizeof(segment));
+    return segment;
+}
+
+// Applies every intact record; end is set to the offset after the last one
+size_t replayRecords(const std::vector<char>& contents, const std::function<void(const Journal::Record&)>& apply,
+                     size_t& end) {
+    size_t offset = HEADER_SIZE;
+    size_t applied = 0;
+    while (offset + 8 <= contents.size()) {
+        uint32_t length, checksum;
+        std::memcpy(&length, &contents[offset], sizeof(length));
+        std::memcpy(&checksum, &contents[offset + 4], sizeof(checksum));
+
+        if (offset + 8 + length > contents.size()) break;
+        const char* payload = &contents[offset + 8];
+        if (crc32(payload, length) != checksum) break;
+
+        Journal::Record record;
+        if (!decode(payload, length, record)) break;
+
+        apply(record);
+        ++applied;
+        offset += 8 + length;
+    }
+    end = offset;
+    return applied;
+}
+
+// Records that the file now holds everything up to and including segment
+bool writeSegmentNumber(const std::string& path, uint64_t segment) {
+    int writeFd = ::open(path.c_str(), O_WRONLY);
+    bool ok = writeFd >= 0 &&
+              ::pwrite(writeFd, &segment, sizeof(segment), MAGIC_SIZE) == static_cast<ssize_t>(sizeof(segment)) &&
+              ::fsync(writeFd) == 0;
+    if (!ok) std::cerr << "Error numbering journal " << path << ": " << std::strerror(errno) << std::endl;
+    if (writeFd >= 0) ::close(writeFd);
+    return ok;
+}
+
+} // namespace
+
+Journal::Journal(const std::string& path)
+    : path(path), fd(-1), nextSequence(0), durableSequence(0), syncCount(0), failed(false), flushing(false),
+      segment(0), fileBytes(0) {
+    lastReplay.records = 0;
+    lastReplay.bytes = 0;
+    lastReplay.skippedBytes = 0;
+    lastReplay.seconds = 0.0;
+}
+
+Journal::~Journal() {
+    close();
+}
+
+bool Journal::open() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd >= 0) return true;
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        std::cerr << "Error opening journal " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Stamp a new (empty) journal with its header; replay() has set the segment it continues
+    struct stat info;
+    fileBytes = 0;
+    if (fstat(fd, &info) == 0) fileBytes = static_cast<uint64_t>(info.st_size);
+    if (fileBytes == 0) {
+        if (segment == 0) segment = 1;
+        std::string header = journalHeader(segment);
+        if (::write(fd, header.data(), header.size()) != static_cast<ssize_t>(header.size())) {
+            std::cerr << "Error writing journal header: " << std::strerror(errno) << std::endl;
+        } else {
+            fileBytes = header.size();
+        }
+    }
+    return true;
+}
+
+void Journal::close() {
+    commit();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+uint64_t Journal::append(const Record& record) {
+    std::string frame = encode(record);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!failed) pending.append(frame);
+    return ++nextSequence;
+}
+
+// Bulk appends (e.g. interest postings) encode outside the lock and take it once
+uint64_t Journal::appendAll(const std::vector<Record>& records) {
+    std::string frames;
+    frames.reserve(records.size() * 64);
+    for (const Record& record : records) {
+        encodeInto(frames, record);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!failed) pending.append(frames);
+    nextSequence += records.size();
+    return nextSequence;
+}
+
+/**
+ * Group commit: the first caller to find records pending becomes the leader,
+ * writes the whole pending buffer and issues one fsync. Callers that arrive
+ * while a flush is in progress wait and are covered by the next flush.
+ * A failed flush drops every pending record and fails the journal, so each
+ * caller whose record isn't durable gets false, and none of those records
+ * is written later.
+ */
+bool Journal::sync(uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (durableSequence < sequence) {
+        if (failed) return false;
+        if (flushing) {
+            flushed.wait(lock);
+            continue;
+        }
+
+        flushing = true;
+        std::string buffer;
+        buffer.swap(pending);
+        uint64_t target = nextSequence;
+        uint64_t offset = fileBytes;
+
+        lock.unlock();
+        bool synced = writeAndSync(buffer, offset);
+        lock.lock();
+
+        if (synced) {
+            ++syncCount;
+            fileBytes += buffer.size();
+            durableSequence = target;
+        } else {
+            std::cerr << "Journal " << path << " failed; no further records will be written" << std::endl;
+            pending.clear();
+            failed = true;
+        }
+        flushing = false;
+        flushed.notify_all();
+    }
+    return true;
+}
+
+bool Journal::commit() {
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sequence = nextSequence;
+    }
+    return sync(sequence);
+}
+
+// Writes buffer at the end of the file (fileOffset bytes long) and fsyncs it. On failure
+// the file is cut back to fileOffset, so a retry doesn't leave a partial copy in front.
+bool Journal::writeAndSync(const std::string& buffer, uint64_t fileOffset) {
+    if (fd < 0) return false;
+    if (buffer.empty()) return true;
+
+    const char* data = buffer.data();
+    size_t remaining = buffer.size();
+    bool ok = true;
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error writing journal: " << std::strerror(errno) << std::endl;
+            ok = false;
+            break;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (ok && ::fsync(fd) != 0) {
+        std::cerr << "Error syncing journal: " << std::strerror(errno) << std::endl;
+        ok = false;
+    }
+    if (!ok && ::ftruncate(fd, static_cast<off_t>(fileOffset)) != 0) {
+        std::cerr << "Error truncating journal: " << std::strerror(errno) << std::endl;
+    }
+    return ok;
+}
+
+/**
+ * Replays the sealed journal, then the current one. A file whose segment is
+ * at or below coveredSegment is already in the caller's snapshot (a checkpoint
+ * or save stopped before removing it): it is skipped and removed instead.
+ */
+size_t Journal::replay(const std::function<void(const Record&)>& apply, uint64_t coveredSegment) {
+    commit();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ReplayStats stats;
+    stats.records = 0;
+    stats.bytes = 0;
+    stats.skippedBytes = 0;
+    uint64_t lastSegment = coveredSegment;   // Newest segment reflected in the caller's state
+
+    // Records sealed by rotate() come first; they were synced before sealing, so
+    // there is nothing to repair in that file
+    std::vector<char> contents;
+    size_t offset;
+    bool sealed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sealed = readFile(getSealedPath(), contents);
+    }
+    uint64_t fileSegment;
+    if (sealed && !isJournal(contents)) {
+        setAside(getSealedPath());   // rotate() would append to it otherwise
+    } else if (sealed && (fileSegment = journalSegment(contents)) <= coveredSegment) {
+        stats.skippedBytes += contents.size();
+        dropSealed();
+    } else if (sealed) {
+        stats.records += replayRecords(contents, apply, offset);
+        stats.bytes += offset - HEADER_SIZE;
+        lastSegment = fileSegment;
+    }
+
+    contents.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readFile(path, contents);
+    }
+    if (!isJournal(contents)) {
+        // No journal yet; open() stamps one that continues the numbering
+        if (!contents.empty()) setAside(path);
+        std::lock_guard<std::mutex> lock(mutex);
+        segment = lastSegment + 1;
+    } else if ((fileSegment = journalSegment(contents)) <= coveredSegment) {
+        stats.skippedBytes += contents.size();
+        std::lock_guard<std::mutex> lock(mutex);
+        segment = lastSegment + 1;
+        restartFile(journalHeader(segment));
+    } else {
+        stats.records += replayRecords(contents, apply, offset);
+        stats.bytes += offset - HEADER_SIZE;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        segment = fileSegment;
+        // Drop a torn or corrupt tail so new records are appended after valid data
+        if (offset < contents.size()) {
+            std::cerr << "Journal: discarding " << (contents.size() - offset)
+                      << " bytes of incomplete records" << std::endl;
+            if (::truncate(path.c_str(), static_cast<off_t>(offset)) != 0) {
+                std::cerr << "Error truncating journal: " << std::strerror(errno) << std::endl;
+            }
+        }
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    lastReplay = stats;
+    return stats.records;
+}
+
+// Replaces the journal file with contents (mutex held); an open journal continues in the new file
+bool Journal::restartFile(const std::string& contents) {
+    if (!writeFileAtomically(path, contents)) return false;
+    if (fd >= 0) {
+        ::close(fd);
+        fd = ::open(path.c_str(), O_RDWR | O_APPEND, 0644);
+        fileBytes = contents.size();
+    }
+    return true;
+}
+
+/**
+ * Checkpoint support: makes every record appended so far durable, moves them
+ * into the sealed journal and continues in a new, empty journal file (the
+ * next segment). Appenders wait for at most one write + fsync. If a sealed
+ * journal is still there (an earlier checkpoint failed), the records are
+ * appended to it and it is renumbered, so it always holds everything since the
+ * last covering snapshot, up to getSegment() - 1.
+ */
+bool Journal::rotate() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (flushing) {
+        flushed.wait(lock);
+    }
+    if (fd < 0 || failed) return false;
+
+    if (!pending.empty()) {
+        if (!writeAndSync(pending, fileBytes)) {
+            std::cerr << "Journal " << path << " failed; no further records will be written" << std::endl;
+            pending.clear();
+            failed = true;
+            flushed.notify_all();
+            return false;
+        }
+        ++syncCount;
+        pending.clear();
+    }
+    durableSequence = nextSequence;
+    flushed.notify_all();
+
+    std::string sealedPath = getSealedPath();
+    struct stat info;
+    if (::stat(sealedPath.c_str(), &info) == 0) {
+        std::vector<char> contents;
+        if (!readFile(path, contents) || contents.size() < HEADER_SIZE ||
+            !appendFileSynced(sealedPath, contents.data() + HEADER_SIZE, contents.size() - HEADER_SIZE) ||
+            !writeSegmentNumber(sealedPath, segment)) {
+            return false;
+        }
+    } else if (std::rename(path.c_str(), sealedPath.c_str()) != 0) {
+        std::cerr << "Error sealing journal " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    ::close(fd);
+    std::string header = journalHeader(++segment);
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0 ||
+        ::write(fd, header.data(), header.size()) != static_cast<ssize_t>(header.size()) ||
+        ::fsync(fd) != 0) {
+        std::cerr << "Error starting journal " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    fileBytes = header.size();
+    return syncParentDirectory(path);
+}
+
+void Journal::dropSealed() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string sealedPath = getSealedPath();
+    if (::unlink(sealedPath.c_str()) == 0) {
+        syncParentDirectory(sealedPath);
+    } else if (errno != ENOENT) {
+        std::cerr << "Error removing " << sealedPath << ": " << std::strerror(errno) << std::endl;
+    }
+}
+
+void Journal::reset() {
+    // Records that can't be written stay in the file's place, as after a crash before the reset
+    if (!commit()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0) return;
+
+        std::string header = journalHeader(++segment);
+        if (::ftruncate(fd, 0) != 0 ||
+            ::write(fd, header.data(), header.size()) != static_cast<ssize_t>(header.size()) ||
+            ::fsync(fd) != 0) {
+            std::cerr << "Error resetting journal: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        fileBytes = header.size();
+    }
+    dropSealed();   // A full save covers the sealed records too
+}
+
+std::string Journal::getPath() const {
+    return path;
+}
+
+std::string Journal::getSealedPath() const {
+    return path + ".sealed";
+}
+
+uint64_t Journal::getSyncCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncCount;
+}
+
+uint64_t Journal::getSegment() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return segment;
+}
+
+uint64_t Journal::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return fileBytes + pending.size();
+}
+
+uint64_t Journal::getSealedSize() const {
+    struct stat info;
+    return ::stat(getSealedPath().c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+}
+
+bool Journal::isFailed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+Journal::ReplayStats Journal::getLastReplay() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastReplay;
+}
@@ -0,0 +1,150 @@
+#include "../../include/utils/LatencyStats.h"
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <cmath>
+
+namespace {
+
+const double PERCENTILES[] = {0.50, 0.90, 0.99, 0.999};
+const char* const PERCENTILE_NAMES[] = {"p50", "p90", "p99", "p99.9"};
+const size_t PERCENTILE_COUNT = 4;
+
+// A short calibration window gives a poor tick rate; wait until this much time has passed
+const int64_t MIN_CALIBRATION_NANOS = 10000000;
+
+std::atomic<unsigned> nextStripe(0);
+
+std::string formatNanos(double nanos) {
+    std::ostringstream text;
+    text << std::fixed;
+    if (nanos < 1e3) {
+        text << std::setprecision(0) << nanos << " ns";
+    } else if (nanos < 1e6) {
+        text << std::setprecision(1) << nanos / 1e3 << " us";
+    } else if (nanos < 1e9) {
+        text << std::setprecision(2) << nanos / 1e6 << " ms";
+    } else {
+        text << std::setprecision(2) << nanos / 1e9 << " s";
+    }
+    return text.str();
+}
+
+} // namespace
+
+LatencyStats::LatencyStats()
+    : stripes(new Stripe[STRIPES]), startTicks(ticks()), startTime(std::chrono::steady_clock::now()) {
+    reset();
+}
+
+const char* LatencyStats::operationName(Operation op) {
+    switch (op) {
+        case CREATE_ACCOUNT:   return "createAccount";
+        case CLOSE_ACCOUNT:    return "closeAccount";
+        case VALIDATE_ACCOUNT: return "validateAccount";
+        case DEPOSIT:          return "deposit";
+        case WITHDRAW:         return "withdraw";
+        case LOAD_DATA:        return "loadData";
+        case SAVE_DATA:        return "saveData";
+        case APPLY_INTEREST:   return "applyInterestToAllSavingsAccounts";
+        case APPLY_BATCH:      return "applyBatch";
+        case CHECKPOINT:       return "checkpoint";
+        default:               return "unknown";
+    }
+}
+
+uint64_t LatencyStats::bucketLow(size_t bucket) {
+    if (bucket < 4) return bucket;
+    unsigned exponent = static_cast<unsigned>(bucket / 4) + 1;
+    return static_cast<uint64_t>(4 + bucket % 4) << (exponent - 2);
+}
+
+// A thread keeps its stripe for life (in every LatencyStats), so short-lived
+// threads eventually push the rest onto the shared stripe
+size_t LatencyStats::claimStripe() {
+    unsigned claimed = nextStripe.fetch_add(1, std::memory_order_relaxed);
+    return (claimed < STRIPES - 1) ? claimed + 1 : SHARED_STRIPE;
+}
+
+void LatencyStats::reset() {
+    for (size_t s = 0; s < STRIPES; ++s) {
+        for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                stripes[s].buckets[op][b].store(0, std::memory_order_relaxed);
+            }
+            stripes[s].totalTicks[op].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+double LatencyStats::nanosPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime).count();
+    if (elapsed < MIN_CALIBRATION_NANOS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(MIN_CALIBRATION_NANOS - elapsed));
+    }
+    // Read the counter right after the clock, so both describe the same instant
+    now = std::chrono::steady_clock::now();
+    uint64_t tickCount = ticks() - startTicks;
+    elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime).count();
+    return tickCount > 0 ? static_cast<double>(elapsed) / tickCount : 1.0;
+#else
+    return 1.0;   // ticks() already counts nanoseconds
+#endif
+}
+
+/**
+ * Writes one row per operation that has been called: call count, mean and
+ * percentiles. A percentile is the midpoint of the bucket it falls in; the
+ * maximum is the upper edge of the highest bucket in use.
+ */
+void LatencyStats::write(std::ostream& out) const {
+    double scale = nanosPerTick();
+
+    out << std::left << std::setw(36) << "Operation" << std::right << std::setw(10) << "Calls"
+        << std::setw(12) << "Mean";
+    for (size_t p = 0; p < PERCENTILE_COUNT; ++p) {
+        out << std::setw(12) << PERCENTILE_NAMES[p];
+    }
+    out << std::setw(12) << "Max" << "\n";
+
+    uint64_t counts[BUCKETS];
+    for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+        uint64_t calls = 0;
+        uint64_t totalTicks = 0;
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            counts[b] = 0;
+            for (size_t s = 0; s < STRIPES; ++s) {
+                counts[b] += stripes[s].buckets[op][b].load(std::memory_order_relaxed);
+            }
+            calls += counts[b];
+        }
+        if (calls == 0) continue;
+        for (size_t s = 0; s < STRIPES; ++s) {
+            totalTicks += stripes[s].totalTicks[op].load(std::memory_order_relaxed);
+        }
+
+        out << std::left << std::setw(36) << operationName(static_cast<Operation>(op)) << std::right
+            << std::setw(10) << calls << std::setw(12) << formatNanos(scale * totalTicks / calls);
+
+        size_t bucket = 0;
+        uint64_t seen = counts[0];
+        for (size_t p = 0; p < PERCENTILE_COUNT; ++p) {
+            // Nearest rank, as in the benchmark tools
+            uint64_t rank = static_cast<uint64_t>(std::ceil(PERCENTILES[p] * calls));
+            if (rank == 0) rank = 1;
+            while (seen < rank) seen += counts[++bucket];
+            double low = static_cast<double>(bucketLow(bucket));
+            double high = (bucket + 1 < BUCKETS) ? static_cast<double>(bucketLow(bucket + 1)) : 2.0 * low;
+            out << std::setw(12) << formatNanos(scale * (low + high) / 2.0);
+        }
+
+        size_t highest = BUCKETS - 1;
+        while (counts[highest] == 0) --highest;
+        double top = (highest + 1 < BUCKETS) ? static_cast<double>(bucketLow(highest + 1))
+                                             : 2.0 * static_cast<double>(bucketLow(highest));
+        out << std::setw(12) << formatNanos(scale * top) << "\n";
+    }
+}
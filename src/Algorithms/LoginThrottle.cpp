@@ -0,0 +1,46 @@
+#include "../../include/utils/LoginThrottle.h"
+#include <chrono>
+
+LoginThrottle::LoginThrottle(uint32_t rate, uint32_t burst)
+    : refilledAt(0), tokenNanos(0), burstNanos(0), rejected(0) {
+    configure(rate, burst);
+}
+
+int64_t LoginThrottle::nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LoginThrottle::configure(uint32_t rate, uint32_t burst) {
+    if (burst == 0) burst = 1;
+    int64_t token = (rate == 0) ? 0 : 1000000000LL / rate;
+    tokenNanos.store(token, std::memory_order_relaxed);
+    burstNanos.store(token * burst, std::memory_order_relaxed);
+    refilledAt.store(0, std::memory_order_relaxed);
+}
+
+bool LoginThrottle::tryAcquire() {
+    int64_t token = tokenNanos.load(std::memory_order_relaxed);
+    if (token == 0) return true;
+    int64_t burst = burstNanos.load(std::memory_order_relaxed);
+    int64_t now = nowNanos();
+
+    int64_t current = refilledAt.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t next = ((current > now) ? current : now) + token;
+        if (next - now > burst) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (refilledAt.compare_exchange_weak(current, next, std::memory_order_relaxed)) return true;
+    }
+}
+
+void LoginThrottle::release() {
+    int64_t token = tokenNanos.load(std::memory_order_relaxed);
+    if (token != 0) refilledAt.fetch_sub(token, std::memory_order_relaxed);
+}
+
+uint64_t LoginThrottle::getRejected() const {
+    return rejected.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,377 @@
+#include "../../include/utils/PasswordHash.h"
+#include <vector>
+#include <utility>
+#include <random>
+#include <cstring>
+
+namespace {
+
+const char* const PREFIX = "$scrypt$";
+const size_t PREFIX_SIZE = 8;
+const uint32_t MAX_BLOCK_FACTOR = 64;
+const uint32_t MAX_PARALLELISM = 16;
+// Tables up to the default cost's stay allocated between calls; bigger ones are freed after use
+const size_t KEPT_SCRATCH_WORDS = (size_t(32) * PasswordHash::BLOCK_FACTOR << PasswordHash::DEFAULT_COST) +
+                                  2 * 32 * PasswordHash::BLOCK_FACTOR;
+
+const uint32_t SHA256_INIT[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+const uint32_t SHA256_ROUND[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotr(uint32_t x, unsigned n) { return (x >> n) | (x << (32 - n)); }
+inline uint32_t rotl(uint32_t x, unsigned n) { return (x << n) | (x >> (32 - n)); }
+
+inline uint32_t loadBigEndian(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline void storeBigEndian(uint8_t* p, uint32_t x) {
+    p[0] = static_cast<uint8_t>(x >> 24);
+    p[1] = static_cast<uint8_t>(x >> 16);
+    p[2] = static_cast<uint8_t>(x >> 8);
+    p[3] = static_cast<uint8_t>(x);
+}
+
+inline uint32_t loadLittleEndian(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void storeLittleEndian(uint8_t* p, uint32_t x) {
+    p[0] = static_cast<uint8_t>(x);
+    p[1] = static_cast<uint8_t>(x >> 8);
+    p[2] = static_cast<uint8_t>(x >> 16);
+    p[3] = static_cast<uint8_t>(x >> 24);
+}
+
+// Incremental SHA-256 (FIPS 180-4)
+struct Sha256 {
+    uint32_t state[8];
+    uint8_t block[64];
+    size_t blockUsed;
+    uint64_t totalBytes;
+
+    Sha256() : blockUsed(0), totalBytes(0) {
+        std::memcpy(state, SHA256_INIT, sizeof(state));
+    }
+
+    void compress(const uint8_t* data) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) w[i] = loadBigEndian(data + 4 * i);
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_ROUND[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    void update(const uint8_t* data, size_t size) {
+        if (size == 0) return;
+        totalBytes += size;
+        if (blockUsed > 0) {
+            size_t take = (size < 64 - blockUsed) ? size : 64 - blockUsed;
+            std::memcpy(block + blockUsed, data, take);
+            blockUsed += take;
+            data += take;
+            size -= take;
+            if (blockUsed < 64) return;
+            compress(block);
+            blockUsed = 0;
+        }
+        for (; size >= 64; data += 64, size -= 64) compress(data);
+        std::memcpy(block, data, size);
+        blockUsed = size;
+    }
+
+    void finish(uint8_t digest[32]) {
+        uint64_t bits = totalBytes * 8;
+        uint8_t padding[72] = {0x80};
+        size_t padSize = (blockUsed < 56) ? 56 - blockUsed : 120 - blockUsed;
+        for (int i = 0; i < 8; ++i) padding[padSize + i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+        update(padding, padSize + 8);
+        for (int i = 0; i < 8; ++i) storeBigEndian(digest + 4 * i, state[i]);
+    }
+};
+
+// HMAC-SHA256 with the key absorbed once; each message copies the two prepared states
+struct HmacSha256 {
+    Sha256 inner;
+    Sha256 outer;
+
+    HmacSha256(const uint8_t* key, size_t keySize) {
+        uint8_t keyBlock[64] = {0};
+        if (keySize > 64) {
+            PasswordHash::sha256(key, keySize, keyBlock);
+        } else if (keySize > 0) {
+            std::memcpy(keyBlock, key, keySize);
+        }
+        uint8_t pad[64];
+        for (int i = 0; i < 64; ++i) pad[i] = keyBlock[i] ^ 0x36;
+        inner.update(pad, 64);
+        for (int i = 0; i < 64; ++i) pad[i] = keyBlock[i] ^ 0x5c;
+        outer.update(pad, 64);
+    }
+
+    // mac = HMAC(key, first || second)
+    void mac(const uint8_t* first, size_t firstSize, const uint8_t* second, size_t secondSize,
+             uint8_t out[32]) const {
+        Sha256 context = inner;
+        context.update(first, firstSize);
+        context.update(second, secondSize);
+        uint8_t innerDigest[32];
+        context.finish(innerDigest);
+        context = outer;
+        context.update(innerDigest, 32);
+        context.finish(out);
+    }
+};
+
+// Salsa20/8 core, in place on 16 words
+void salsa20_8(uint32_t b[16]) {
+    uint32_t x[16];
+    std::memcpy(x, b, sizeof(x));
+    for (int round = 0; round < 8; round += 2) {
+        x[ 4] ^= rotl(x[ 0] + x[12],  7);  x[ 8] ^= rotl(x[ 4] + x[ 0],  9);
+        x[12] ^= rotl(x[ 8] + x[ 4], 13);  x[ 0] ^= rotl(x[12] + x[ 8], 18);
+        x[ 9] ^= rotl(x[ 5] + x[ 1],  7);  x[13] ^= rotl(x[ 9] + x[ 5],  9);
+        x[ 1] ^= rotl(x[13] + x[ 9], 13);  x[ 5] ^= rotl(x[ 1] + x[13], 18);
+        x[14] ^= rotl(x[10] + x[ 6],  7);  x[ 2] ^= rotl(x[14] + x[10],  9);
+        x[ 6] ^= rotl(x[ 2] + x[14], 13);  x[10] ^= rotl(x[ 6] + x[ 2], 18);
+        x[ 3] ^= rotl(x[15] + x[11],  7);  x[ 7] ^= rotl(x[ 3] + x[15],  9);
+        x[11] ^= rotl(x[ 7] + x[ 3], 13);  x[15] ^= rotl(x[11] + x[ 7], 18);
+        x[ 1] ^= rotl(x[ 0] + x[ 3],  7);  x[ 2] ^= rotl(x[ 1] + x[ 0],  9);
+        x[ 3] ^= rotl(x[ 2] + x[ 1], 13);  x[ 0] ^= rotl(x[ 3] + x[ 2], 18);
+        x[ 6] ^= rotl(x[ 5] + x[ 4],  7);  x[ 7] ^= rotl(x[ 6] + x[ 5],  9);
+        x[ 4] ^= rotl(x[ 7] + x[ 6], 13);  x[ 5] ^= rotl(x[ 4] + x[ 7], 18);
+        x[11] ^= rotl(x[10] + x[ 9],  7);  x[ 8] ^= rotl(x[11] + x[10],  9);
+        x[ 9] ^= rotl(x[ 8] + x[11], 13);  x[10] ^= rotl(x[ 9] + x[ 8], 18);
+        x[12] ^= rotl(x[15] + x[14],  7);  x[13] ^= rotl(x[12] + x[15],  9);
+        x[14] ^= rotl(x[13] + x[12], 13);  x[15] ^= rotl(x[14] + x[13], 18);
+    }
+    for (int i = 0; i < 16; ++i) b[i] += x[i];
+}
+
+// scrypt BlockMix: in and out are 2r 64-byte blocks (32r words); even outputs first, then odd
+void blockMix(const uint32_t* in, uint32_t* out, uint32_t r) {
+    uint32_t x[16];
+    std::memcpy(x, in + (2 * r - 1) * 16, sizeof(x));
+    for (uint32_t i = 0; i < 2 * r; ++i) {
+        for (int k = 0; k < 16; ++k) x[k] ^= in[i * 16 + k];
+        salsa20_8(x);
+        std::memcpy(out + ((i % 2) * r + i / 2) * 16, x, sizeof(x));
+    }
+}
+
+// scrypt ROMix on one 128r-byte block; v holds n * 32r words, xy 64r words
+void roMix(uint8_t* block, uint64_t n, uint32_t r, uint32_t* v, uint32_t* xy) {
+    size_t words = 32 * static_cast<size_t>(r);
+    uint32_t* x = xy;
+    uint32_t* y = xy + words;
+    for (size_t k = 0; k < words; ++k) x[k] = loadLittleEndian(block + 4 * k);
+
+    for (uint64_t i = 0; i < n; ++i) {
+        std::memcpy(v + i * words, x, words * sizeof(uint32_t));
+        blockMix(x, y, r);
+        std::swap(x, y);
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+        uint64_t j = x[(2 * r - 1) * 16] & (n - 1);   // Integerify (n is a power of two below 2^32)
+        const uint32_t* vj = v + j * words;
+        for (size_t k = 0; k < words; ++k) x[k] ^= vj[k];
+        blockMix(x, y, r);
+        std::swap(x, y);
+    }
+
+    for (size_t k = 0; k < words; ++k) storeLittleEndian(block + 4 * k, x[k]);
+}
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+std::string toHex(const uint8_t* data, size_t size) {
+    std::string text(size * 2, '0');
+    for (size_t i = 0; i < size; ++i) {
+        text[2 * i] = HEX_DIGITS[data[i] >> 4];
+        text[2 * i + 1] = HEX_DIGITS[data[i] & 15];
+    }
+    return text;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool fromHex(const std::string& text, std::vector<uint8_t>& out) {
+    if (text.empty() || text.size() % 2 != 0) return false;
+    out.resize(text.size() / 2);
+    for (size_t i = 0; i < out.size(); ++i) {
+        int high = hexValue(text[2 * i]);
+        int low = hexValue(text[2 * i + 1]);
+        if (high < 0 || low < 0) return false;
+        out[i] = static_cast<uint8_t>(high * 16 + low);
+    }
+    return true;
+}
+
+bool parseNumber(const std::string& text, uint32_t limit, uint32_t& value) {
+    if (text.empty() || text.size() > 2) return false;
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + static_cast<uint32_t>(c - '0');
+    }
+    return value >= 1 && value <= limit;
+}
+
+// The parts of a stored hash
+struct ParsedHash {
+    uint32_t cost;
+    uint32_t r;
+    uint32_t p;
+    std::vector<uint8_t> salt;
+    std::vector<uint8_t> key;
+};
+
+bool parseHash(const std::string& stored, ParsedHash& parsed) {
+    if (stored.compare(0, PREFIX_SIZE, PREFIX) != 0) return false;
+    std::string fields[5];
+    size_t start = PREFIX_SIZE;
+    for (int i = 0; i < 5; ++i) {
+        size_t end = (i < 4) ? stored.find('$', start) : stored.size();
+        if (end == std::string::npos) return false;
+        fields[i] = stored.substr(start, end - start);
+        start = end + 1;
+    }
+    // r is checked too: cost MAX_COST with r = 64 would need 2 GiB
+    return parseNumber(fields[0], PasswordHash::MAX_COST, parsed.cost) &&
+           parseNumber(fields[1], MAX_BLOCK_FACTOR, parsed.r) &&
+           parseNumber(fields[2], MAX_PARALLELISM, parsed.p) &&
+           (uint64_t(128) * parsed.r << parsed.cost) <= PasswordHash::MAX_MEMORY &&
+           fromHex(fields[3], parsed.salt) && fromHex(fields[4], parsed.key) &&
+           parsed.key.size() == PasswordHash::KEY_SIZE;
+}
+
+// Compares without stopping at the first difference, so timing reveals nothing about the match
+bool constantTimeEquals(const uint8_t* a, const uint8_t* b, size_t size) {
+    uint8_t difference = 0;
+    for (size_t i = 0; i < size; ++i) difference |= a[i] ^ b[i];
+    return difference == 0;
+}
+
+const uint8_t* bytes(const std::string& text) {
+    return reinterpret_cast<const uint8_t*>(text.data());
+}
+
+} // namespace
+
+void PasswordHash::sha256(const uint8_t* data, size_t size, uint8_t digest[32]) {
+    Sha256 context;
+    context.update(data, size);
+    context.finish(digest);
+}
+
+void PasswordHash::pbkdf2Sha256(const uint8_t* password, size_t passwordSize, const uint8_t* salt,
+                                size_t saltSize, uint32_t iterations, uint8_t* out, size_t outSize) {
+    HmacSha256 hmac(password, passwordSize);
+    for (uint32_t blockIndex = 1; outSize > 0; ++blockIndex) {
+        uint8_t counter[4];
+        storeBigEndian(counter, blockIndex);
+        uint8_t u[32];
+        uint8_t t[32];
+        hmac.mac(salt, saltSize, counter, 4, u);
+        std::memcpy(t, u, 32);
+        for (uint32_t i = 1; i < iterations; ++i) {
+            hmac.mac(u, 32, nullptr, 0, u);
+            for (int k = 0; k < 32; ++k) t[k] ^= u[k];
+        }
+        size_t take = (outSize < 32) ? outSize : 32;
+        std::memcpy(out, t, take);
+        out += take;
+        outSize -= take;
+    }
+}
+
+/**
+ * scrypt (RFC 7914). n must be a power of two. The n * 128r-byte table is a
+ * per-thread buffer kept between calls, so the verification workers allocate
+ * it once rather than once per login; a table larger than the default cost's
+ * is released afterwards instead of staying with the thread.
+ */
+void PasswordHash::scrypt(const uint8_t* password, size_t passwordSize, const uint8_t* salt, size_t saltSize,
+                          uint64_t n, uint32_t r, uint32_t p, uint8_t* out, size_t outSize) {
+    static thread_local std::vector<uint32_t> scratch;
+    size_t blockSize = 128 * static_cast<size_t>(r);
+    size_t words = 32 * static_cast<size_t>(r);
+    size_t needed = static_cast<size_t>(n) * words + 2 * words;
+    if (scratch.size() < needed) scratch.resize(needed);
+
+    std::vector<uint8_t> blocks(blockSize * p);
+    pbkdf2Sha256(password, passwordSize, salt, saltSize, 1, blocks.data(), blocks.size());
+    for (uint32_t i = 0; i < p; ++i) {
+        roMix(blocks.data() + i * blockSize, n, r, scratch.data() + 2 * words, scratch.data());
+    }
+    pbkdf2Sha256(password, passwordSize, blocks.data(), blocks.size(), 1, out, outSize);
+    if (scratch.size() > KEPT_SCRATCH_WORDS) std::vector<uint32_t>().swap(scratch);
+}
+
+std::string PasswordHash::hash(const std::string& password, unsigned cost) {
+    if (cost < MIN_COST) cost = MIN_COST;
+    if (cost > MAX_COST) cost = MAX_COST;
+
+    static thread_local std::random_device entropy;
+    uint8_t salt[SALT_SIZE];
+    for (size_t i = 0; i < SALT_SIZE; i += 4) {
+        storeLittleEndian(salt + i, entropy());
+    }
+
+    uint8_t key[KEY_SIZE];
+    scrypt(bytes(password), password.size(), salt, SALT_SIZE, uint64_t(1) << cost, BLOCK_FACTOR, 1, key, KEY_SIZE);
+    return PREFIX + std::to_string(cost) + "$" + std::to_string(BLOCK_FACTOR) + "$1$" +
+           toHex(salt, SALT_SIZE) + "$" + toHex(key, KEY_SIZE);
+}
+
+bool PasswordHash::verify(const std::string& password, const std::string& stored) {
+    ParsedHash parsed;
+    if (!parseHash(stored, parsed)) {
+        // Legacy plaintext credential (not migrated yet)
+        return password.size() == stored.size() && constantTimeEquals(bytes(password), bytes(stored), stored.size());
+    }
+    uint8_t key[KEY_SIZE];
+    scrypt(bytes(password), password.size(), parsed.salt.data(), parsed.salt.size(),
+           uint64_t(1) << parsed.cost, parsed.r, parsed.p, key, KEY_SIZE);
+    return constantTimeEquals(key, parsed.key.data(), KEY_SIZE);
+}
+
+bool PasswordHash::isHash(const std::string& stored) {
+    ParsedHash parsed;
+    return parseHash(stored, parsed);
+}
+
+unsigned PasswordHash::costOf(const std::string& stored) {
+    ParsedHash parsed;
+    return parseHash(stored, parsed) ? parsed.cost : 0;
+}
@@ -0,0 +1,91 @@
+#include "../../include/utils/PasswordVerifier.h"
+#include "../../include/utils/PasswordHash.h"
+#include <iostream>
+#include <exception>
+
+PasswordVerifier::PasswordVerifier(unsigned threads) : stopping(false) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.push_back(std::thread(&PasswordVerifier::workerLoop, this));
+    }
+}
+
+PasswordVerifier::~PasswordVerifier() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void PasswordVerifier::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;   // Stopping, and nothing left to do
+
+        Batch* batch = queue.front();
+        Job& job = batch->jobs[batch->next++];
+        if (batch->next == batch->count) queue.pop_front();
+        lock.unlock();
+
+        try {
+            if (job.type == Job::HASH) {
+                job.credential = PasswordHash::hash(job.password, job.cost);
+            } else {
+                job.matched = PasswordHash::verify(job.password, job.credential);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error hashing password: " << e.what() << std::endl;
+            if (job.type == Job::HASH) job.credential.clear();
+            job.matched = false;
+        }
+
+        lock.lock();
+        if (--batch->remaining == 0) finished.notify_all();
+    }
+}
+
+void PasswordVerifier::run(std::vector<Job>& jobs) {
+    if (jobs.empty()) return;
+    Batch batch;
+    batch.jobs = jobs.data();
+    batch.count = jobs.size();
+    batch.next = 0;
+    batch.remaining = jobs.size();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    queue.push_back(&batch);
+    if (jobs.size() == 1) {
+        work.notify_one();
+    } else {
+        work.notify_all();
+    }
+    finished.wait(lock, [&batch] { return batch.remaining == 0; });
+}
+
+bool PasswordVerifier::verify(const std::string& password, const std::string& stored) {
+    std::vector<Job> jobs(1);
+    jobs[0].type = Job::VERIFY;
+    jobs[0].password = password;
+    jobs[0].credential = stored;
+    run(jobs);
+    return jobs[0].matched;
+}
+
+std::string PasswordVerifier::hash(const std::string& password, unsigned cost) {
+    std::vector<Job> jobs(1);
+    jobs[0].type = Job::HASH;
+    jobs[0].password = password;
+    jobs[0].cost = cost;
+    run(jobs);
+    return jobs[0].credential;
+}
+
+size_t PasswordVerifier::getThreadCount() const {
+    return workers.size();
+}
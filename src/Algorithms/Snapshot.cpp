@@ -0,0 +1,361 @@
+#include "../../include/utils/Snapshot.h"
+#include "../../include/utils/Algorithms.h"
+#include "../../include/utils/MappedFile.h"
+#include "../../include/utils/FileHandler.h"
+#include "../../include/System details/CheckingAccount.h"
+#include "../../include/System details/SavingsAccount.h"
+#include <iostream>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <unordered_map>
+#include <unistd.h>
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'B', 'A', 'N', 'K', 'S', 'N', 'P', '1'};
+const char LEDGER_MAGIC[8] = {'B', 'A', 'N', 'K', 'L', 'D', 'G', '1'};
+
+std::string ledgerHeader() {
+    Snapshot::LedgerHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LEDGER_MAGIC, sizeof(LEDGER_MAGIC));
+    header.version = Snapshot::VERSION;
+    header.recordSize = sizeof(Transaction);
+    return std::string(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+// Appends a frame holding rows to out
+void appendLedgerFrame(std::string& out, const Transaction* rows, size_t count, size_t firstRow,
+                       uint64_t transactionBytes) {
+    const char* rowBytes = reinterpret_cast<const char*>(rows);
+    size_t rowsSize = count * sizeof(Transaction);
+
+    Snapshot::LedgerFrame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.firstRow = firstRow;
+    frame.rowCount = count;
+    frame.transactionBytes = transactionBytes;
+    frame.rowsChecksum = crc32(rowBytes, rowsSize);
+    frame.frameChecksum = crc32(reinterpret_cast<const char*>(&frame), offsetof(Snapshot::LedgerFrame, frameChecksum));
+
+    out.reserve(out.size() + sizeof(frame) + rowsSize);
+    out.append(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    out.append(rowBytes, rowsSize);
+}
+
+// Appends a string to the string table and returns its reference
+Snapshot::StringRef addString(std::string& table, const std::string& value) {
+    Snapshot::StringRef ref;
+    ref.offset = static_cast<uint32_t>(table.size());
+    ref.length = static_cast<uint32_t>(value.size());
+    table.append(value);
+    return ref;
+}
+
+int64_t accountParameter(const Account* acc) {
+    switch (acc->getKind()) {
+        case Account::CHECKING:
+            return static_cast<const CheckingAccount*>(acc)->getTransactionFee().getCents();
+        case Account::SAVINGS:
+            return static_cast<const SavingsAccount*>(acc)->getInterestRate().getMicros();
+        case Account::BASIC:
+            break;
+    }
+    return 0;
+}
+
+// Bounds-checked view over the string table of a mapped snapshot
+struct StringTable {
+    const char* data;
+    uint64_t size;
+
+    bool valid(const Snapshot::StringRef& ref) const {
+        return static_cast<uint64_t>(ref.offset) + ref.length <= size;
+    }
+
+    std::string get(const Snapshot::StringRef& ref) const {
+        return std::string(data + ref.offset, ref.length);
+    }
+};
+
+// Recreates the account a record describes; the record must have been validated
+Account* createAccount(const Snapshot::AccountRecord& record, const StringTable& strings, AccountPool& pool) {
+    std::string id = strings.get(record.id);
+    Money balance = Money::fromCents(record.balanceCents);
+    if (record.kind == Account::CHECKING) {
+        return pool.create<CheckingAccount>(id, strings.get(record.name), balance,
+                                            strings.get(record.password), Money::fromCents(record.param));
+    }
+    if (record.kind == Account::SAVINGS) {
+        return pool.create<SavingsAccount>(id, strings.get(record.name), balance, strings.get(record.password),
+                                           InterestRate::fromMicros(record.param),
+                                           static_cast<std::time_t>(record.accruedThrough), record.accrualCarry);
+    }
+    return pool.create<Account>(id, strings.get(record.name), strings.get(record.type),
+                                balance, strings.get(record.password));
+}
+
+// Applies change segment rows to accounts in place: a changed account replaces its row (or
+// is added), a closed one is removed
+void foldAccountChanges(std::vector<Account*>& accounts, const std::vector<Account*>& changes,
+                        const std::vector<AccountId>& closed, AccountPool& pool) {
+    std::unordered_map<uint32_t, size_t> slots;
+    for (size_t i = 0; i < accounts.size(); ++i) {
+        slots[AccountId::fromString(accounts[i]->getAccountId()).getValue()] = i;
+    }
+    for (Account* acc : changes) {
+        uint32_t id = AccountId::fromString(acc->getAccountId()).getValue();
+        std::unordered_map<uint32_t, size_t>::iterator slot = slots.find(id);
+        if (slot == slots.end()) {
+            slots[id] = accounts.size();
+            accounts.push_back(acc);
+        } else {
+            pool.destroy(accounts[slot->second]);
+            accounts[slot->second] = acc;
+        }
+    }
+    for (AccountId id : closed) {
+        std::unordered_map<uint32_t, size_t>::iterator slot = slots.find(id.getValue());
+        if (slot != slots.end() && accounts[slot->second] != nullptr) {
+            pool.destroy(accounts[slot->second]);
+            accounts[slot->second] = nullptr;
+        }
+    }
+    accounts.erase(std::remove(accounts.begin(), accounts.end(), static_cast<Account*>(nullptr)), accounts.end());
+}
+
+} // namespace
+
+Snapshot::Snapshot(const std::string& snapFile) : snapshotFilePath(snapFile) {}
+
+bool Snapshot::exists() const {
+    return ::access(snapshotFilePath.c_str(), F_OK) == 0;
+}
+
+std::string Snapshot::getPath() const {
+    return snapshotFilePath;
+}
+
+std::string Snapshot::getLedgerPath() const {
+    return snapshotFilePath + ".ledger";
+}
+
+void Snapshot::Image::setBase(const FileHandler::ChangeBase& position) {
+    base = position;
+}
+
+void Snapshot::Image::addAccount(const Account* acc) {
+    AccountRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.id = addString(strings, acc->getAccountId());
+    record.name = addString(strings, acc->getCustomerName());
+    record.type = addString(strings, acc->getAccountType());
+    record.password = addString(strings, acc->getPassword());
+    record.balanceCents = acc->getBalance().getCents();
+    record.param = accountParameter(acc);
+    record.kind = acc->getKind();
+    if (record.kind == Account::SAVINGS) {
+        const SavingsAccount* savings = static_cast<const SavingsAccount*>(acc);
+        record.accruedThrough = static_cast<int64_t>(savings->getAccruedThrough());
+        record.accrualCarry = savings->getAccrualCarry();
+    }
+    accountRecords.push_back(record);
+}
+
+void Snapshot::Image::reserve(size_t accounts) {
+    accountRecords.reserve(accounts);
+}
+
+size_t Snapshot::Image::getAccountCount() const {
+    return accountRecords.size();
+}
+
+void Snapshot::Image::restoreAccounts(std::vector<Account*>& accounts, AccountPool& pool) const {
+    StringTable table = {strings.data(), strings.size()};
+    accounts.reserve(accounts.size() + accountRecords.size());
+    for (const AccountRecord& record : accountRecords) {
+        accounts.push_back(createAccount(record, table, pool));
+    }
+}
+
+bool Snapshot::save(const std::vector<Account*>& accounts, const FileHandler::ChangeBase& position) const {
+    Image image;
+    image.setBase(position);
+    image.reserve(accounts.size());
+    for (const Account* acc : accounts) {
+        image.addAccount(acc);
+    }
+    return write(image);
+}
+
+bool Snapshot::write(const Image& image) const {
+    const char* accountBytes = reinterpret_cast<const char*>(image.accountRecords.data());
+    size_t accountsSize = image.accountRecords.size() * sizeof(AccountRecord);
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.accountCount = image.accountRecords.size();
+    header.stringTableSize = image.strings.size();
+    header.transactionRows = image.base.transactionRows;
+    header.transactionBytes = image.base.transactionBytes;
+    header.journalSegment = image.base.journalSegment;
+    header.accountsChecksum = crc32(accountBytes, accountsSize);
+    header.stringsChecksum = crc32(image.strings.data(), image.strings.size());
+    header.headerChecksum = crc32(reinterpret_cast<const char*>(&header), offsetof(Header, headerChecksum));
+
+    std::string contents;
+    contents.reserve(sizeof(Header) + accountsSize + image.strings.size());
+    contents.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    contents.append(accountBytes, accountsSize);
+    contents.append(image.strings);
+
+    return writeFileAtomically(snapshotFilePath, contents);
+}
+
+bool Snapshot::load(std::vector<Account*>& accounts, AccountPool& pool, FileHandler::ChangeBase& position) const {
+    MappedFile file;
+    if (!file.open(snapshotFilePath) || file.size() < sizeof(Header)) return false;
+
+    Header header;
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 && header.version != VERSION) {
+        std::cerr << "Snapshot " << snapshotFilePath << " has unsupported version " << header.version << std::endl;
+        return false;
+    }
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header.headerSize != sizeof(Header) ||
+        header.headerChecksum != crc32(reinterpret_cast<const char*>(&header),
+                                       offsetof(Header, headerChecksum))) {
+        std::cerr << "Snapshot " << snapshotFilePath << " has an invalid header" << std::endl;
+        return false;
+    }
+
+    uint64_t accountsSize = header.accountCount * sizeof(AccountRecord);
+    if (sizeof(Header) + accountsSize + header.stringTableSize != file.size()) {
+        std::cerr << "Snapshot " << snapshotFilePath << " is truncated" << std::endl;
+        return false;
+    }
+
+    const char* accountBytes = file.data() + sizeof(Header);
+    StringTable strings = {accountBytes + accountsSize, header.stringTableSize};
+
+    if (crc32(accountBytes, accountsSize) != header.accountsChecksum ||
+        crc32(strings.data, strings.size) != header.stringsChecksum) {
+        std::cerr << "Snapshot " << snapshotFilePath << " failed its checksum" << std::endl;
+        return false;
+    }
+
+    // Build into a temporary so a bad record leaves the caller's container untouched
+    std::vector<Account*> loadedAccounts;
+    loadedAccounts.reserve(header.accountCount);
+    for (uint64_t i = 0; i < header.accountCount; ++i) {
+        AccountRecord record;
+        std::memcpy(&record, accountBytes + i * sizeof(AccountRecord), sizeof(AccountRecord));
+        if (!strings.valid(record.id) || !strings.valid(record.name) ||
+            !strings.valid(record.type) || !strings.valid(record.password) ||
+            record.kind > Account::SAVINGS) {
+            std::cerr << "Snapshot " << snapshotFilePath << " has an invalid record" << std::endl;
+            for (Account* acc : loadedAccounts) {
+                pool.destroy(acc);
+            }
+            return false;
+        }
+        loadedAccounts.push_back(createAccount(record, strings, pool));
+    }
+
+    accounts.insert(accounts.end(), loadedAccounts.begin(), loadedAccounts.end());
+    position.transactionRows = header.transactionRows;
+    position.transactionBytes = header.transactionBytes;
+    position.journalSegment = header.journalSegment;
+    return true;
+}
+
+bool Snapshot::appendLedger(const Transaction* rows, size_t count, size_t firstRow,
+                            uint64_t transactionBytes) const {
+    if (count == 0) return true;
+    std::string frame;
+    appendLedgerFrame(frame, rows, count, firstRow, transactionBytes);
+    return appendFileSynced(getLedgerPath(), frame.data(), frame.size());
+}
+
+bool Snapshot::writeLedger(const std::vector<Transaction>& rows, uint64_t transactionBytes) const {
+    std::string contents = ledgerHeader();
+    appendLedgerFrame(contents, rows.data(), rows.size(), 0, transactionBytes);
+    return writeFileAtomically(getLedgerPath(), contents);
+}
+
+/**
+ * Reads frames until the end of the file or the first one that is torn,
+ * corrupt or doesn't continue the rows before it; the rows before that point
+ * are still good, and transactionBytes says which part of the transactions
+ * file they match.
+ */
+bool Snapshot::loadLedger(std::vector<Transaction>& transactions, uint64_t& transactionBytes) const {
+    MappedFile file;
+    if (!file.open(getLedgerPath()) || file.size() < sizeof(LedgerHeader)) return false;
+    std::string expected = ledgerHeader();
+    if (std::memcmp(file.data(), expected.data(), expected.size()) != 0) {
+        std::cerr << "Ledger " << getLedgerPath() << " has an invalid header" << std::endl;
+        return false;
+    }
+
+    size_t first = transactions.size();
+    transactionBytes = 0;
+    size_t offset = sizeof(LedgerHeader);
+    while (offset + sizeof(LedgerFrame) <= file.size()) {
+        LedgerFrame frame;
+        std::memcpy(&frame, file.data() + offset, sizeof(frame));
+        const char* rowBytes = file.data() + offset + sizeof(frame);
+        uint64_t rowsSize = frame.rowCount * sizeof(Transaction);
+        if (frame.frameChecksum != crc32(reinterpret_cast<const char*>(&frame), offsetof(LedgerFrame, frameChecksum)) ||
+            frame.firstRow != transactions.size() - first ||
+            rowsSize > file.size() - offset - sizeof(frame) ||
+            crc32(rowBytes, rowsSize) != frame.rowsChecksum) {
+            break;
+        }
+
+        size_t end = transactions.size();
+        transactions.resize(end + frame.rowCount);
+        std::memcpy(static_cast<void*>(&transactions[end]), rowBytes, rowsSize);
+        transactionBytes = frame.transactionBytes;
+        offset += sizeof(frame) + rowsSize;
+    }
+    return true;
+}
+
+bool convertCSVToSnapshot(const std::string& accFile, const std::string& transFile,
+                          const std::string& snapFile) {
+    AccountPool pool;
+    std::vector<Account*> accounts;
+    std::vector<Transaction> transactions;
+    FileHandler fileHandler(accFile, transFile);
+    fileHandler.loadAccounts(accounts, pool);
+    fileHandler.loadTransactions(transactions);
+
+    // Without a change segment: the whole transactions file and no journal segment
+    FileHandler::ChangeBase base = fileHandler.getChangeBase(transactions.size(), 0);
+    std::vector<Account*> changes;
+    std::vector<AccountId> closed;
+    uint64_t changesSegment = 0;
+    if (fileHandler.loadAccountChanges(changes, closed, pool, base, changesSegment)) {
+        // The accounts saved incrementally since are folded in, and the snapshot takes the
+        // segment's base, so BankSystem::loadData still accepts the segment on top of it
+        foldAccountChanges(accounts, changes, closed, pool);
+    }
+    Snapshot snapshot(snapFile);
+    return snapshot.save(accounts, base) &&
+           snapshot.writeLedger(transactions, fileHandler.getChangeBase(transactions.size(), 0).transactionBytes);
+}
+
+bool convertSnapshotToCSV(const std::string& snapFile, const std::string& accFile) {
+    AccountPool pool;
+    std::vector<Account*> accounts;
+    FileHandler::ChangeBase position;
+    if (!Snapshot(snapFile).load(accounts, pool, position)) return false;
+
+    return FileHandler(accFile).saveAccounts(accounts);
+}
@@ -1,37 +1,711 @@
 #include "../../include/Bank System/BankSystem.h"
 #include "../../include/utils/Algorithms.h"
+#include "../../include/utils/InterestEngine.h"
+#include "../../include/utils/PasswordHash.h"
 #include <iostream>
 #include <iomanip>
 #include <ctime>
-#include <random>
 #include <algorithm>
+#include <functional>
+#include <unordered_set>
+#include <pthread.h>
+#include <sched.h>
 
-BankSystem::BankSystem(const std::string& accFile, const std::string& transFile)
-    : fileHandler(accFile, transFile) {
+BankSystem::BankSystem(const std::string& accFile, const std::string& transFile,
+                       const std::string& journalFile, const std::string& snapFile,
+                       size_t shardCount, uint32_t maxAccountNumber, unsigned passwordCost)
+    : idAllocator(AccountIdAllocator::DEFAULT_FIRST, maxAccountNumber),
+      fileHandler(accFile, transFile), journal(journalFile), snapshot(snapFile), passwordCost(passwordCost),
+      persistedTransactionCount(0), accountChangesValid(false), ledgerInSync(false), interestPostedCents(0), persisterStopping(false),
+      checkpointInterval(0), checkpointMutations(0), mutationsSinceCheckpoint(0), checkpointJournalBytes(0),
+      checkpointCount(0), lastCheckpointSeconds(0.0), totalCheckpointSeconds(0.0), foldedJournalBytes(0) {
+    if (shardCount == 0) shardCount = 1;
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(std::unique_ptr<AccountShard>(new AccountShard()));
+    }
+    if (this->passwordCost < PasswordHash::MIN_COST) this->passwordCost = PasswordHash::MIN_COST;
+    if (this->passwordCost > PasswordHash::MAX_COST) this->passwordCost = PasswordHash::MAX_COST;
     loadData();
+    migratePasswords();
 }
 
 BankSystem::~BankSystem() {
+    stopPersister();
     saveData();
-    // Clean up dynamically allocated Account objects
-    for (auto& pair : accounts) {
-        delete pair.second;
+    // Release every account at once (slab by slab) instead of one delete per account
+    for (auto& shard : shards) {
+        shard->accounts.clear();
+    }
+    accountPool.clear();
+}
+
+BankSystem::AccountShard& BankSystem::shardFor(AccountId id) const {
+    return *shards[id.getValue() % shards.size()];
+}
+
+std::vector<std::unique_lock<std::mutex> > BankSystem::lockAllShards() const {
+    std::vector<std::unique_lock<std::mutex> > locks;
+    locks.reserve(shards.size());
+    for (const auto& shard : shards) {
+        locks.push_back(std::unique_lock<std::mutex>(shard->mutex));
+    }
+    return locks;
+}
+
+// Gathers every shard into one list ordered by account ID (for display and saving);
+// the caller must hold all shard locks
+std::vector<Account*> BankSystem::collectAccounts() const {
+    std::vector<std::pair<AccountId, Account*> > entries;
+    for (const auto& shard : shards) {
+        shard->accounts.forEach([&](AccountId id, Account* acc) {
+            entries.push_back(std::make_pair(id, acc));
+        });
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const std::pair<AccountId, Account*>& a, const std::pair<AccountId, Account*>& b) {
+                  return a.first < b.first;
+              });
+
+    std::vector<Account*> ordered;
+    ordered.reserve(entries.size());
+    for (const auto& entry : entries) {
+        ordered.push_back(entry.second);
+    }
+    return ordered;
+}
+
+// Indexes freshly loaded accounts; later rows for the same ID replace earlier ones
+void BankSystem::addLoadedAccounts(std::vector<Account*>& loaded) {
+    for (Account* acc : loaded) {
+        AccountId id = AccountId::fromString(acc->getAccountId());
+        if (!id.isValid()) {
+            std::cerr << "Error loading account data: invalid account ID " << acc->getAccountId() << std::endl;
+            accountPool.destroy(acc);
+            continue;
+        }
+        idAllocator.markUsed(id);
+        accountPool.destroy(shardFor(id).accounts.replace(id, acc));
     }
+    loaded.clear();
 }
 
+/**
+ * Loads the last saved state, preferring the binary snapshot over the CSV
+ * files for the accounts and the snapshot's ledger file over the
+ * transactions file for the ledger, then applies the account changes saved
+ * incrementally since, and finally replays the journal on top of it to
+ * recover every mutation made after the last save (e.g. before a crash).
+ * Journal segments the snapshot covers are skipped, so only the tail after
+ * the last checkpoint is replayed; from the CSV files the whole journal is.
+ * A ledger file that doesn't match the transactions file is rebuilt from it.
+ */
 void BankSystem::loadData() {
-    fileHandler.loadAccounts(accounts);
-    fileHandler.loadTransactions(allTransactions);
+    BANK_STATS_SCOPE(latencyStats, LOAD_DATA);
+    auto locks = lockAllShards();
+
+    std::vector<Account*> loaded;
+    std::vector<AccountId> closed;
+    uint64_t coveredSegment = 0;    // Newest journal segment already in the loaded state
+    allTransactions.access([&](std::vector<Transaction>& transactions) {
+        FileHandler::ChangeBase position;   // Where the snapshot sits in the transactions file and journal
+        bool fromSnapshot = snapshot.exists() && snapshot.load(loaded, accountPool, position);
+        if (!fromSnapshot) {
+            fileHandler.loadAccounts(loaded, accountPool);
+        }
+        // Rows saved after the snapshot are in the ledger too; replay skips their journal records
+        uint64_t transactionBytes = fileHandler.getChangeBase(0, 0).transactionBytes;
+        uint64_t ledgerBytes = 0;
+        ledgerInSync = snapshot.loadLedger(transactions, ledgerBytes) && ledgerBytes == transactionBytes;
+        if (!ledgerInSync) {
+            transactions.clear();
+            fileHandler.loadTransactions(transactions);
+            ledgerInSync = snapshot.writeLedger(transactions, transactionBytes);
+        }
+        if (fromSnapshot && transactions.size() < position.transactionRows) {
+            // The balances are still right, but part of the history they came from is gone
+            std::cerr << "Transactions file holds " << transactions.size() << " row(s), the snapshot expects "
+                      << position.transactionRows << std::endl;
+            position.transactionRows = 0;   // No change segment can line up with it
+        }
+
+        // The change segment starts where the last full save (snapshot included) ended. One that
+        // doesn't line up with the snapshot is older than it (a save stopped in between) and is
+        // dropped; on top of the CSV files it is applied, and the next save rewrites everything.
+        std::vector<Account*> changes;
+        FileHandler::ChangeBase base;
+        uint64_t changesSegment = 0;   // Newest journal segment the change segment covers
+        bool hasChanges = fileHandler.loadAccountChanges(changes, closed, accountPool, base, changesSegment);
+        accountChangesValid = fromSnapshot && hasChanges && base.transactionRows == position.transactionRows &&
+                              base.transactionBytes == position.transactionBytes &&
+                              base.journalSegment == position.journalSegment;
+        if (fromSnapshot && hasChanges && !accountChangesValid) {
+            std::cerr << "Ignoring " << fileHandler.getAccountChangesPath() << ": it doesn't line up with the snapshot" << std::endl;
+            for (Account* acc : changes) {
+                accountPool.destroy(acc);
+            }
+            changes.clear();
+            closed.clear();
+        }
+        loaded.insert(loaded.end(), changes.begin(), changes.end());
+        if (fromSnapshot) coveredSegment = accountChangesValid ? changesSegment : position.journalSegment;
+        persistedTransactionCount = transactions.size();
+
+        // Closed accounts keep their history, so their numbers stay reserved
+        for (const auto& trans : transactions) {
+            idAllocator.markUsed(trans.getAccountId());
+        }
+    });
+    addLoadedAccounts(loaded);
+    for (AccountId id : closed) {
+        idAllocator.markUsed(id);
+        AccountIndex& accounts = shardFor(id).accounts;
+        Account* acc = accounts.find(id);
+        if (acc != nullptr) {
+            accounts.erase(id);
+            accountPool.destroy(acc);
+        }
+    }
+
+    // IDs of transactions that reached the transactions file before a crash,
+    // only collected when there is actually something to replay
+    std::unordered_set<uint64_t> persistedIds;
+    bool idsCollected = false;
+
+    size_t replayed = journal.replay([&](const Journal::Record& record) {
+        if (!idsCollected) {
+            allTransactions.access([&](std::vector<Transaction>& transactions) {
+                for (size_t i = 0; i < persistedTransactionCount; ++i) {
+                    persistedIds.insert(transactions[i].getTransactionId().getValue());
+                }
+            });
+            idsCollected = true;
+        }
+        applyJournalRecord(record, persistedIds);
+    }, coveredSegment);
+    if (replayed > 0) {
+        std::cout << "Recovered " << replayed << " journaled operation(s)." << std::endl;
+    }
+
+    journal.open();
 }
 
+/**
+ * Makes everything since the last save durable outside the journal, then
+ * empties the journal. Usually that is the new transactions plus the rows of
+ * the accounts that changed, so the cost follows the amount of change; the
+ * accounts file and the snapshot are only rewritten when the change segment
+ * has grown large or the files on disk can't be continued.
+ */
 void BankSystem::saveData() {
-    fileHandler.saveAccounts(accounts);
-    fileHandler.saveTransactions(allTransactions);
+    BANK_STATS_SCOPE(latencyStats, SAVE_DATA);
+    std::lock_guard<std::mutex> persist(persistMutex);
+    auto locks = lockAllShards();
+
+    size_t accountCount = 0;
+    size_t changedCount = 0;
+    for (const auto& shard : shards) {
+        accountCount += shard->accounts.size();
+        changedCount += shard->changed.size();
+    }
+
+    // Memory holds operations the journal lost and their callers were told failed
+    if (!journal.commit()) {
+        std::cerr << "Not saving: the journal could not be written" << std::endl;
+        return;
+    }
+    if (needsFullSave(accountCount, changedCount) ? saveAll() : saveChanges()) {
+        journal.reset();
+    }
+}
+
+// The change segment can't take the next changes if it doesn't continue the files on disk,
+// or once it would hold a quarter of all accounts (at least MIN_MERGE_ROWS rows)
+bool BankSystem::needsFullSave(size_t accountCount, size_t changedCount) const {
+    size_t mergeRows = accountCount / 4;
+    if (mergeRows < MIN_MERGE_ROWS) mergeRows = MIN_MERGE_ROWS;
+    return !accountChangesValid || fileHandler.getAccountChangeCount() + changedCount >= mergeRows;
+}
+
+// New transactions first: if the account rows don't make it, the journal still has them
+bool BankSystem::saveChanges() {
+    std::vector<const Account*> changed;
+    std::vector<AccountId> closed;
+    for (const auto& shard : shards) {
+        for (uint32_t value : shard->changed) {
+            AccountId id(value);
+            const Account* acc = shard->accounts.find(id);
+            if (acc != nullptr) {
+                changed.push_back(acc);
+            } else {
+                closed.push_back(id);
+            }
+        }
+    }
+
+    bool saved = false;
+    allTransactions.access([&](std::vector<Transaction>& transactions) {
+        if (!fileHandler.appendTransactions(transactions, persistedTransactionCount)) return;
+        appendToLedger(transactions.data() + persistedTransactionCount,
+                       transactions.size() - persistedTransactionCount, persistedTransactionCount);
+        persistedTransactionCount = transactions.size();
+        saved = fileHandler.appendAccountChanges(changed, closed);
+    });
+    if (saved) {
+        for (const auto& shard : shards) {
+            shard->changed.clear();
+        }
+    }
+    return saved;
+}
+
+// Transactions, accounts file, snapshot (accounts plus where the ledger ends), then a
+// fresh change segment based on all three
+bool BankSystem::saveAll() {
+    std::vector<Account*> ordered = collectAccounts();
+    bool saved = false;
+    allTransactions.access([&](std::vector<Transaction>& transactions) {
+        if (!fileHandler.appendTransactions(transactions, persistedTransactionCount)) return;
+        if (ledgerInSync) {
+            appendToLedger(transactions.data() + persistedTransactionCount,
+                           transactions.size() - persistedTransactionCount, persistedTransactionCount);
+        } else {
+            ledgerInSync = snapshot.writeLedger(transactions, fileHandler.getChangeBase(0, 0).transactionBytes);
+        }
+        persistedTransactionCount = transactions.size();
+        // Every journaled record is in memory (the journal was committed under all shard locks),
+        // so the snapshot covers the current segment; reset() starts the next one
+        FileHandler::ChangeBase base = fileHandler.getChangeBase(transactions.size(), journal.getSegment());
+        saved = fileHandler.saveAccounts(ordered) && snapshot.save(ordered, base) &&
+                fileHandler.startAccountChanges(base);
+    });
+    if (saved) {
+        for (const auto& shard : shards) {
+            shard->changed.clear();
+        }
+    }
+    accountChangesValid = saved;
+    return saved;
+}
+
+// Called right after rows were appended to the transactions file (persistMutex held). Once an
+// append fails the ledger file stays behind until the next full save; start-up checks it anyway.
+void BankSystem::appendToLedger(const Transaction* rows, size_t count, size_t firstRow) {
+    if (!ledgerInSync || count == 0) return;
+    ledgerInSync = snapshot.appendLedger(rows, count, firstRow, fileHandler.getChangeBase(0, 0).transactionBytes);
+}
+
+/**
+ * Folds the journal into the files while other sessions keep running. The
+ * journal is rotated first, so every earlier mutation is sealed and every
+ * later one goes to the new journal. Then, like an incremental save, the
+ * transactions not saved yet are appended to the ledger (copied a chunk at a
+ * time) and the accounts changed since the last save to the change segment
+ * (copied one shard at a time), followed by the sealed segment's number; the
+ * cost follows the amount of change, not the number of accounts or the
+ * length of the history. When saveData() would write everything (see
+ * needsFullSave), so does the checkpoint: the accounts file and the snapshot
+ * are rewritten and the change segment starts over.
+ * A mutation landing during the copy can be in both the files and the new
+ * journal, which replay tolerates (records carry the resulting balance,
+ * transactions are matched by ID). Files are written off every lock, and the
+ * sealed journal is dropped once they are complete; until then it is skipped
+ * at start-up if the files already cover it.
+ */
+bool BankSystem::checkpoint() {
+    BANK_STATS_SCOPE(latencyStats, CHECKPOINT);
+    std::lock_guard<std::mutex> persist(persistMutex);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!journal.rotate()) return false;
+    uint64_t sealedSegment = journal.getSegment() - 1;
+
+    size_t accountCount = 0;
+    size_t changedCount = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        accountCount += shard->accounts.size();
+        changedCount += shard->changed.size();
+    }
+    bool full = needsFullSave(accountCount, changedCount);
+
+    // Every mutation journaled before the rotation held its shard lock, so once each shard
+    // has been locked here the ledger holds all of their transactions too
+    Snapshot::Image image;
+    std::vector<AccountId> closed;
+    image.reserve(full ? accountCount : changedCount);
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        if (full) {
+            shard->accounts.forEach([&](AccountId, Account* acc) {
+                image.addAccount(acc);
+            });
+        } else {
+            for (uint32_t value : shard->changed) {
+                const Account* acc = shard->accounts.find(AccountId(value));
+                if (acc != nullptr) {
+                    image.addAccount(acc);
+                } else {
+                    closed.push_back(AccountId(value));
+                }
+            }
+        }
+        shard->changed.clear();
+    }
+    // The marks are gone, so until the files are written the next save must be a full one
+    accountChangesValid = false;
+
+    std::vector<Transaction> unsaved;   // Not in the transactions file yet
+    const TransactionLog& ledger = allTransactions;
+    size_t end = ledger.size();
+    for (size_t next = persistedTransactionCount; next < end; next += CHECKPOINT_CHUNK) {
+        size_t stop = std::min(end, next + CHECKPOINT_CHUNK);
+        ledger.access([&](const std::vector<Transaction>& transactions) {
+            unsaved.insert(unsaved.end(), transactions.begin() + next, transactions.begin() + stop);
+        });
+    }
+    // What was copied must be durable in the journal first: a mutation whose record is lost
+    // was reported as failed and must not reach the files
+    if (!journal.commit()) return false;
+    if (!fileHandler.appendTransactions(unsaved, 0)) return false;
+    appendToLedger(unsaved.data(), unsaved.size(), persistedTransactionCount);
+    persistedTransactionCount = end;
+
+    AccountPool pool;
+    std::vector<Account*> accounts;
+    image.restoreAccounts(accounts, pool);
+    if (full) {
+        // The CSV files stand in for an unusable snapshot, so they must cover the sealed records too
+        FileHandler::ChangeBase base = fileHandler.getChangeBase(end, sealedSegment);
+        image.setBase(base);
+        std::sort(accounts.begin(), accounts.end(), [](const Account* a, const Account* b) {
+            return AccountId::fromString(a->getAccountId()) < AccountId::fromString(b->getAccountId());
+        });
+        if (!snapshot.write(image) || !fileHandler.saveAccounts(accounts) ||
+            !fileHandler.startAccountChanges(base)) {
+            return false;
+        }
+    } else {
+        std::vector<const Account*> changed(accounts.begin(), accounts.end());
+        if (!fileHandler.appendAccountChanges(changed, closed, sealedSegment)) return false;
+    }
+    accountChangesValid = true;
+
+    uint64_t folded = journal.getSealedSize();
+    journal.dropSealed();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(checkpointStatsMutex);
+    ++checkpointCount;
+    lastCheckpointSeconds = seconds;
+    totalCheckpointSeconds += seconds;
+    foldedJournalBytes += folded;
+    return true;
+}
+
+void BankSystem::startPersister(std::chrono::seconds interval, uint64_t everyMutations,
+                                uint64_t journalBytes) {
+    stopPersister();
+    if (interval.count() <= 0 && everyMutations == 0 && journalBytes == 0) return;
+
+    checkpointInterval = interval;
+    checkpointMutations = everyMutations;
+    checkpointJournalBytes = journalBytes;
+    mutationsSinceCheckpoint = 0;
+    persisterStopping = false;
+    persister = std::thread(&BankSystem::persisterLoop, this);
+}
+
+void BankSystem::stopPersister() {
+    if (!persister.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(persisterMutex);
+        persisterStopping = true;
+    }
+    persisterWake.notify_one();
+    persister.join();
+    checkpointMutations = 0;
+}
+
+void BankSystem::persisterLoop() {
+#ifdef SCHED_IDLE
+    // Checkpoints only run when no session wants the CPU; a deposit never waits out their time slice
+    sched_param idle;
+    idle.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &idle);
+#endif
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration poll = std::chrono::seconds(1);   // Checks the journal size, catches a missed wake-up
+    Clock::time_point due = Clock::now() + checkpointInterval;
+
+    std::unique_lock<std::mutex> lock(persisterMutex);
+    while (!persisterStopping) {
+        Clock::time_point wake = Clock::now() + poll;
+        if (checkpointInterval.count() > 0 && due < wake) wake = due;
+        persisterWake.wait_until(lock, wake);
+        if (persisterStopping) break;
+
+        uint64_t mutations = mutationsSinceCheckpoint.load();
+        bool timeUp = checkpointInterval.count() > 0 && Clock::now() >= due;
+        bool countReached = checkpointMutations != 0 && mutations >= checkpointMutations;
+        // The journal can also be long from start-up (a replayed tail) with no new mutations
+        bool sizeReached = checkpointJournalBytes != 0 && journal.getSize() >= checkpointJournalBytes;
+        if (!timeUp && !countReached && !sizeReached) continue;
+
+        due = Clock::now() + checkpointInterval;
+        if (mutations == 0 && !sizeReached) continue;   // Nothing new to write
+
+        lock.unlock();
+        mutationsSinceCheckpoint -= mutations;
+        checkpoint();
+        lock.lock();
+    }
+}
+
+void BankSystem::noteMutation() {
+    uint64_t count = mutationsSinceCheckpoint.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (count == checkpointMutations.load(std::memory_order_relaxed)) {
+        persisterWake.notify_one();
+    }
+}
+
+void BankSystem::markChanged(AccountId id) {
+    shardFor(id).changed.insert(id.getValue());
+}
+
+/**
+ * Applies one journal record. Records carry the resulting balance, so replay is
+ * idempotent: re-applying a record that already reached the CSV files is harmless.
+ * Runs during loadData with every shard locked.
+ */
+void BankSystem::applyJournalRecord(const Journal::Record& record,
+                                    const std::unordered_set<uint64_t>& persistedIds) {
+    AccountId id = AccountId::fromString(record.accountId);
+    if (!id.isValid()) return;
+    idAllocator.markUsed(id);
+    markChanged(id);   // The files may predate the record
+    AccountIndex& accounts = shardFor(id).accounts;
+    Account* existing = accounts.find(id);
+
+    switch (record.type) {
+        case Journal::CREATE_ACCOUNT: {
+            Account* acc;
+            if (record.accountType == "Checking") {
+                acc = accountPool.create<CheckingAccount>(record.accountId, record.customerName, record.balance,
+                                                          record.password, record.transactionFee);
+            } else if (record.accountType == "Savings") {
+                acc = accountPool.create<SavingsAccount>(record.accountId, record.customerName, record.balance,
+                                                         record.password, record.interestRate,
+                                                         static_cast<std::time_t>(record.timestamp));
+            } else {
+                acc = accountPool.create<Account>(record.accountId, record.customerName, record.accountType,
+                                                  record.balance, record.password);
+            }
+            accountPool.destroy(accounts.replace(id, acc));
+            break;
+        }
+        case Journal::CLOSE_ACCOUNT:
+            if (existing != nullptr) {
+                accounts.erase(id);
+                accountPool.destroy(existing);
+            }
+            break;
+        case Journal::DEPOSIT:
+        case Journal::WITHDRAWAL:
+            if (existing != nullptr) {
+                existing->restoreBalance(record.balance);
+            }
+            if (persistedIds.count(record.transactionId.getValue()) == 0) {
+                allTransactions.append(Transaction(record.transactionId, id,
+                    record.type == Journal::DEPOSIT ? Transaction::DEPOSIT : Transaction::WITHDRAWAL,
+                    record.amount, static_cast<std::time_t>(record.timestamp)));
+            }
+            break;
+        case Journal::INTEREST_ACCRUED:
+            if (existing != nullptr && existing->getKind() == Account::SAVINGS) {
+                existing->restoreBalance(record.balance);
+                static_cast<SavingsAccount*>(existing)->restoreAccrual(static_cast<std::time_t>(record.timestamp),
+                                                                       record.accrualCarry);
+            }
+            if (record.amount.isPositive() && persistedIds.count(record.transactionId.getValue()) == 0) {
+                allTransactions.append(Transaction(record.transactionId, id, Transaction::DEPOSIT,
+                    record.amount, static_cast<std::time_t>(record.timestamp)));
+            }
+            break;
+    }
+}
+
+uint64_t BankSystem::journalTransaction(const Account* acc, const Transaction& trans) {
+    Journal::Record record;
+    record.type = (trans.getType() == Transaction::DEPOSIT) ? Journal::DEPOSIT : Journal::WITHDRAWAL;
+    record.accountId = acc->getAccountId();
+    record.transactionId = trans.getTransactionId();
+    record.amount = trans.getAmount();
+    record.timestamp = static_cast<int64_t>(trans.getTimestamp());
+    record.balance = acc->getBalance();
+    markChanged(trans.getAccountId());
+    noteMutation();
+    return journal.append(record);
+}
+
+uint64_t BankSystem::journalAccountCreated(const Account* acc) {
+    Journal::Record record;
+    record.type = Journal::CREATE_ACCOUNT;
+    record.accountId = acc->getAccountId();
+    record.customerName = acc->getCustomerName();
+    record.accountType = acc->getAccountType();
+    record.password = acc->getPassword();
+    record.balance = acc->getBalance();
+    record.timestamp = static_cast<int64_t>(std::time(nullptr));
+
+    if (acc->getKind() == Account::CHECKING) {
+        record.transactionFee = static_cast<const CheckingAccount*>(acc)->getTransactionFee();
+    } else if (acc->getKind() == Account::SAVINGS) {
+        const SavingsAccount* savings = static_cast<const SavingsAccount*>(acc);
+        record.interestRate = savings->getInterestRate();
+        record.timestamp = static_cast<int64_t>(savings->getAccruedThrough());
+    }
+    markChanged(AccountId::fromString(record.accountId));
+    noteMutation();
+    return journal.append(record);
+}
+
+uint64_t BankSystem::journalAccountClosed(const std::string& accountId) {
+    Journal::Record record;
+    record.type = Journal::CLOSE_ACCOUNT;
+    record.accountId = accountId;
+    markChanged(AccountId::fromString(accountId));
+    noteMutation();
+    return journal.append(record);
+}
+
+namespace {
+
+// Journal record of an accrual that just happened on acc (interest is its posted amount)
+Journal::Record accrualRecord(const SavingsAccount* acc, Money interest) {
+    Journal::Record record;
+    record.type = Journal::INTEREST_ACCRUED;
+    record.accountId = acc->getAccountId();
+    if (interest.isPositive()) {
+        record.transactionId = acc->getLastTransaction().getTransactionId();
+    }
+    record.amount = interest;
+    record.timestamp = static_cast<int64_t>(acc->getAccruedThrough());
+    record.accrualCarry = acc->getAccrualCarry();
+    record.balance = acc->getBalance();
+    return record;
+}
+
+} // namespace
+
+/**
+ * Accrues a savings account's interest for the whole days elapsed since it
+ * was last touched, before the caller reads or changes its balance. The
+ * posting (if any) goes to the ledger and every accrual to the journal, so
+ * replay restores the accrual time too. Returns the journal sequence number,
+ * or 0 for other kinds and accounts already up to date.
+ */
+uint64_t BankSystem::accrueInterest(Account* acc, std::time_t now) {
+    if (acc->getKind() != Account::SAVINGS) return 0;
+    SavingsAccount* savings = static_cast<SavingsAccount*>(acc);
+
+    Money interest;
+    if (!savings->accrueInterest(now, interest)) return 0;
+    if (interest.isPositive()) {
+        allTransactions.append(savings->getLastTransaction());
+        interestPostedCents += interest.getCents();
+    }
+    markChanged(AccountId::fromString(savings->getAccountId()));
+    return journal.append(accrualRecord(savings, interest));
+}
+
+/**
+ * Brings every savings account up to now through the interest engine, which
+ * accrues them across worker threads. The postings are then added to the
+ * ledger and the journal in one bulk append each; the caller syncs.
+ * Accounts already accrued today cost one comparison.
+ */
+void BankSystem::accrueAllSavingsAccounts(std::time_t now) {
+    InterestEngine engine(now);
+    for (const auto& shard : shards) {
+        shard->accounts.forEach([&](AccountId, Account* acc) {
+            if (acc->getKind() == Account::SAVINGS) {
+                engine.add(static_cast<SavingsAccount*>(acc));
+            }
+        });
+    }
+
+    std::vector<InterestEngine::Accrual> accruals;
+    engine.run(accruals);
+    if (accruals.empty()) return;
+
+    std::vector<Transaction> postings;
+    std::vector<Journal::Record> records;
+    postings.reserve(accruals.size());
+    records.reserve(accruals.size());
+    int64_t posted = 0;
+    for (const auto& accrual : accruals) {
+        if (accrual.interest.isPositive()) {
+            postings.push_back(accrual.account->getLastTransaction());
+            posted += accrual.interest.getCents();
+        }
+        records.push_back(accrualRecord(accrual.account, accrual.interest));
+        markChanged(AccountId::fromString(records.back().accountId));
+    }
+
+    allTransactions.access([&](std::vector<Transaction>& transactions) {
+        transactions.insert(transactions.end(), postings.begin(), postings.end());
+    });
+    journal.appendAll(records);
+    interestPostedCents += posted;
+}
+
+/**
+ * Adds the deposit/withdrawal the account just completed to the global
+ * transaction list and the journal, under the same transaction ID and time as
+ * the account's own record (amount is the requested one, without fees).
+ * Returns the journal sequence number; the caller decides when to sync.
+ * The caller holds the account's shard lock, which keeps per-account order.
+ */
+uint64_t BankSystem::recordTransaction(const Account* acc, Money amount) {
+    const Transaction& completed = acc->getLastTransaction();
+    Transaction trans(completed.getTransactionId(), completed.getAccountId(), completed.getType(),
+                      amount, completed.getTimestamp());
+    allTransactions.append(trans);
+    return journalTransaction(acc, trans);
+}
+
+bool BankSystem::isSupportedAccountType(const std::string& accountType) {
+    return accountType == "Checking" || accountType == "Savings";
+}
+
+/**
+ * Creates and registers a new account under an ID taken from idAllocator,
+ * without any console output. The type must be supported and the credential
+ * already hashed (see passwordVerifier).
+ * shardsLocked tells whether the caller already holds every shard lock (batches).
+ */
+Account* BankSystem::openAccount(AccountId id, const std::string& name, const std::string& accountType,
+                                 Money initialBalance, const std::string& credential,
+                                 bool shardsLocked) {
+    std::string accountId = id.toString();
+    Account* acc;
+    if (accountType == "Checking") {
+        acc = accountPool.create<CheckingAccount>(accountId, name, initialBalance, credential);
+    } else {
+        acc = accountPool.create<SavingsAccount>(accountId, name, initialBalance, credential);
+    }
+
+    AccountShard& shard = shardFor(id);
+    std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+    if (!shardsLocked) lock.lock();
+    shard.accounts.insert(id, acc);
+    journalAccountCreated(acc);
+    return acc;
 }
 
 bool BankSystem::createAccount(const std::string& name, const std::string& accountType, 
-                              double initialBalance, const std::string& password) {
-    if (initialBalance < 0) return false;
+                              Money initialBalance, const std::string& password) {
+    BANK_STATS_SCOPE(latencyStats, CREATE_ACCOUNT);
+    if (initialBalance.isNegative() || isReadOnly()) return false;
     
     // Check password strength
     int strength = checkPasswordStrength(password);
@@ -41,67 +715,103 @@ bool BankSystem::createAccount(const std::string& name, const std::string& accou
                   << "numbers, and special characters." << std::endl;
     }
     
-    // Create account with map of void pointers for the generateUniqueAccountId function
-    std::map<std::string, void*> accountsPtr;
-    for (const auto& pair : accounts) {
-        accountsPtr[pair.first] = nullptr;
+    if (!isSupportedAccountType(accountType)) {
+        return false;
     }
-    
-    std::string id = generateUniqueAccountId(accountsPtr);
-    
-    if (accountType == "Checking") {
-        accounts[id] = new CheckingAccount(id, name, initialBalance, password);
-    } else if (accountType == "Savings") {
-        accounts[id] = new SavingsAccount(id, name, initialBalance, password);
-    } else {
+
+    // Hashed before an account number is taken, so a failure leaves nothing behind
+    std::string credential = passwordVerifier.hash(password, passwordCost);
+    if (credential.empty()) {
+        return false;
+    }
+
+    AccountId id = idAllocator.allocate();
+    if (!id.isValid()) {
+        std::cout << "No account numbers are left; account not created." << std::endl;
+        return false;
+    }
+    openAccount(id, name, accountType, initialBalance, credential, false);
+    if (!journal.commit()) {
+        std::cout << "The new account could not be saved." << std::endl;
         return false;
     }
     
-    std::cout << "Account created successfully. Your account number is: " << id << std::endl;
+    std::cout << "Account created successfully. Your account number is: " << id.toString() << std::endl;
     return true;
 }
 
 bool BankSystem::closeAccount(const std::string& accountId, const std::string& password) {
-    if (accountId.empty() || password.empty()) {
+    BANK_STATS_SCOPE(latencyStats, CLOSE_ACCOUNT);
+    if (accountId.empty() || password.empty() || isReadOnly()) {
         return false;
     }
     
-    auto it = accounts.find(accountId);
-    if (it == accounts.end()) {
+    AccountId id = AccountId::fromString(accountId);
+    bool needsCleanup = false;
+    CredentialCheck check = checkCredentials(id, password, needsCleanup);
+    if (check == LOGINS_THROTTLED) {
+        std::cout << "Too many failed logins right now. Please try again shortly." << std::endl;
+        return false;
+    }
+    if (check == ACCOUNT_MISSING) {
         std::cout << "Account not found." << std::endl;
         return false;
     }
-    
-    try {
+    if (check == ACCOUNT_MARKED) {
         // Check if account is marked for deletion due to security
-        if (it->second->shouldBeDeleted()) {
-            std::cout << "This account has been marked for deletion due to security concerns." << std::endl;
-            cleanupDeletedAccounts(); // Remove it now
+        std::cout << "This account has been marked for deletion due to security concerns." << std::endl;
+        needsCleanup = true;
+    }
+
+    bool closed = false;
+    uint64_t sequence = 0;
+    if (check == CREDENTIALS_VALID) {
+        AccountShard& shard = shardFor(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // Another session may have closed it while the password was checked
+        Account* acc = shard.accounts.find(id);
+        if (acc == nullptr) {
+            std::cout << "Account not found." << std::endl;
             return false;
         }
-        
-        // Use the validatePassword method to check the password and track attempts
-        if (!it->second->validatePassword(password)) {
-            // Clean up any accounts that should be deleted after failed attempts
-            cleanupDeletedAccounts();
+    
+        try {
+            // Account validated successfully, now close it (with the interest earned so far)
+            accrueInterest(acc, std::time(nullptr));
+            Account* accountToDelete = acc;
+            shard.accounts.erase(id); // Remove from the index first to prevent dangling references
+            accountPool.destroy(accountToDelete); // Then return its slot to the pool
+            sequence = journalAccountClosed(accountId);
+            closed = true;
+        } catch (const std::exception& e) {
+            std::cerr << "Error during account closure: " << e.what() << std::endl;
             return false;
         }
-        
-        // Account validated successfully, now close it
-        Account* accountToDelete = it->second;
-        accounts.erase(it); // Remove from map first to prevent dangling references
-        delete accountToDelete; // Then delete the object
-        
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Error during account closure: " << e.what() << std::endl;
-        return false;
     }
+
+    if (closed) {
+        return journal.sync(sequence);
+    } else if (needsCleanup) {
+        // Clean up any accounts that should be deleted after failed attempts
+        cleanupDeletedAccounts();
+    }
+    return closed;
 }
 
+/**
+ * Returns the account object for an ID. The pointer is only safe to use while
+ * no other thread can close the account (e.g. the interactive session).
+ */
 Account* BankSystem::findAccount(const std::string& accountId) {
-    auto it = accounts.find(accountId);
-    return (it != accounts.end()) ? it->second : nullptr;
+    AccountId id = AccountId::fromString(accountId);
+    AccountShard& shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Account* acc = shard.accounts.find(id);
+    if (acc != nullptr) {
+        accrueInterest(acc, std::time(nullptr));   // The caller reads the balance
+    }
+    return acc;
 }
 
 /**
@@ -117,145 +827,574 @@ Account* BankSystem::findAccount(const std::string& accountId) {
  * @return bool True if login is successful, false otherwise
  */
 bool BankSystem::validateAccount(const std::string& accountId, const std::string& password) {
+    BANK_STATS_SCOPE(latencyStats, VALIDATE_ACCOUNT);
     // Basic input validation
     if (accountId.empty() || password.empty()) {
         return false;
     }
     
-    // Find the account in the system
-    Account* acc = findAccount(accountId);
-    if (acc == nullptr) {
+    bool needsCleanup = false;
+    CredentialCheck check = checkCredentials(AccountId::fromString(accountId), password, needsCleanup);
+    if (check == LOGINS_THROTTLED) {
+        std::cout << "Too many failed logins right now. Please try again shortly." << std::endl;
+        return false;
+    }
+    if (check == ACCOUNT_MISSING) {
         std::cout << "Account not found or invalid credentials." << std::endl;
         return false;
     }
-    
-    // Security check: account might already be marked for deletion
-    if (acc->shouldBeDeleted()) {
+    if (check == ACCOUNT_MARKED) {
+        // Security check: account might already be marked for deletion
         std::cout << "This account has been marked for deletion due to security concerns." << std::endl;
         return false;
     }
     
-    try {
-        // Delegate to the account's password validation which handles failed attempts tracking
-        bool result = acc->validatePassword(password);
-        
-        // After validation attempt (success or failure), clean up any accounts
-        // that should be deleted due to excessive failed attempts
+    // After a failed attempt, clean up any accounts that should be deleted
+    // due to excessive failed attempts (outside the shard lock)
+    if (needsCleanup) {
         cleanupDeletedAccounts();
-        
-        return result;
-    } catch (const std::exception& e) {
-        std::cerr << "Error during account validation: " << e.what() << std::endl;
-        return false;
     }
+    return check == CREDENTIALS_VALID;
+}
+
+/**
+ * Checks a password in three steps, so the KDF never runs under a shard lock:
+ * 1. Under the lock: the lockout check and a copy of the stored credential
+ * 2. Unlocked: the hash comparison, on the verification pool
+ * 3. Under the lock again: the attempt is booked on the account (if it still
+ *    exists), which may lock it or mark it for deletion
+ * The bank-wide loginThrottle comes first and turns attempts away while
+ * failures arrive faster than its rate.
+ * A credential hashed at another cost (or still plaintext) is rehashed at
+ * passwordCost after a successful check. The new hash goes out with the next
+ * save; it isn't journaled, since losing it only means rehashing again.
+ */
+BankSystem::CredentialCheck BankSystem::checkCredentials(AccountId id, const std::string& password,
+                                                         bool& needsCleanup) {
+    // Every attempt holds a token until it succeeds, so storms of failures run the bucket dry
+    if (!loginThrottle.tryAcquire()) return LOGINS_THROTTLED;
+    AccountShard& shard = shardFor(id);
+    std::string stored;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Account* acc = shard.accounts.find(id);
+        if (acc == nullptr) return ACCOUNT_MISSING;
+        if (acc->shouldBeDeleted()) return ACCOUNT_MARKED;
+        if (!acc->beginLogin()) {
+            needsCleanup = acc->shouldBeDeleted();
+            return CREDENTIALS_INVALID;
+        }
+        stored = acc->getPassword();
+    }
+
+    bool matched = passwordVerifier.verify(password, stored);
+
+    bool valid;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Account* acc = shard.accounts.find(id);
+        if (acc == nullptr) return ACCOUNT_MISSING;   // Closed in the meantime
+        valid = acc->finishLogin(matched);
+        needsCleanup = acc->shouldBeDeleted();
+    }
+    if (!valid) return CREDENTIALS_INVALID;
+    loginThrottle.release();
+
+    if (PasswordHash::costOf(stored) != passwordCost) {
+        std::string credential = passwordVerifier.hash(password, passwordCost);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Account* acc = shard.accounts.find(id);
+        if (acc != nullptr && !credential.empty() && acc->getPassword() == stored) {
+            acc->setPassword(credential);
+            markChanged(id);
+        }
+    }
+    return CREDENTIALS_VALID;
+}
+
+/**
+ * One-shot upgrade of plaintext credentials (files written before passwords
+ * were hashed, or journaled creations replayed from then): they are hashed
+ * on the verification pool, spread across its workers, and everything is
+ * saved in full, so no plaintext is left in the files when this returns.
+ */
+void BankSystem::migratePasswords() {
+    std::vector<AccountId> ids;
+    std::vector<PasswordVerifier::Job> jobs;
+    {
+        auto locks = lockAllShards();
+        for (const auto& shard : shards) {
+            shard->accounts.forEach([&](AccountId id, Account* acc) {
+                if (PasswordHash::isHash(acc->getPassword())) return;
+                PasswordVerifier::Job job;
+                job.type = PasswordVerifier::Job::HASH;
+                job.password = acc->getPassword();
+                job.cost = passwordCost;
+                ids.push_back(id);
+                jobs.push_back(job);
+            });
+        }
+    }
+    if (jobs.empty()) return;
+
+    std::cout << "Hashing " << jobs.size() << " plaintext password(s)..." << std::endl;
+    passwordVerifier.run(jobs);
+
+    {
+        auto locks = lockAllShards();
+        for (size_t i = 0; i < ids.size(); ++i) {
+            Account* acc = shardFor(ids[i]).accounts.find(ids[i]);
+            if (acc == nullptr || jobs[i].credential.empty() || acc->getPassword() != jobs[i].password) continue;
+            acc->setPassword(jobs[i].credential);
+            markChanged(ids[i]);
+        }
+        accountChangesValid = false;   // Rewrite the accounts file, not just append the new rows
+    }
+    saveData();
+}
+
+void BankSystem::setLoginThrottle(uint32_t failuresPerSecond, uint32_t burst) {
+    loginThrottle.configure(failuresPerSecond, burst);
+}
+
+uint64_t BankSystem::getThrottledLogins() const {
+    return loginThrottle.getRejected();
 }
 
 /**
  * Removes accounts that have been marked for deletion due to security concerns
  * This is an important security measure to prevent brute force attacks
  * 
- * Implementation note: This uses a two-phase approach for safe cleanup:
+ * Implementation note: This uses a two-phase approach for safe cleanup, one shard at a time:
  * 1. First identify all accounts to delete (to avoid modifying the map during iteration)
  * 2. Then perform the actual deletion of those accounts
  */
 void BankSystem::cleanupDeletedAccounts() {
+    uint64_t sequence = 0;
     try {
-        // Create a list to store account IDs that need to be deleted
-        std::vector<std::string> accountsToDelete;
-        
-        // Phase 1: Identify accounts that should be deleted
-        // We can't delete during iteration as it would invalidate the iterator
-        for (const auto& pair : accounts) {
-            if (pair.second != nullptr && pair.second->shouldBeDeleted()) {
-                accountsToDelete.push_back(pair.first);
-            }
-        }
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+
+            // Phase 1: Identify accounts that should be deleted
+            // We can't delete during iteration as it would move entries in the index
+            std::vector<AccountId> accountsToDelete;
+            shard->accounts.forEach([&](AccountId id, Account* acc) {
+                if (acc->shouldBeDeleted()) {
+                    accountsToDelete.push_back(id);
+                }
+            });
         
-        // Phase 2: Delete the identified accounts
-        for (const auto& accountId : accountsToDelete) {
-            std::cout << "SECURITY ALERT: Account " << accountId << " has been DELETED due to multiple failed login attempts." << std::endl;
+            // Phase 2: Delete the identified accounts
+            for (AccountId id : accountsToDelete) {
+                std::string accountId = id.toString();
+                std::cout << "SECURITY ALERT: Account " << accountId << " has been DELETED due to multiple failed login attempts." << std::endl;
             
-            auto it = accounts.find(accountId);
-            if (it != accounts.end() && it->second != nullptr) {
                 // Store pointer to avoid memory leak
-                Account* accountToDelete = it->second;
+                Account* accountToDelete = shard->accounts.find(id);
                 
-                // First remove from map to prevent dangling pointers
-                accounts.erase(it);
+                // First remove from the index to prevent dangling pointers
+                shard->accounts.erase(id);
                 
-                // Then delete the account object to free memory
-                delete accountToDelete;
+                // Then destroy the account object and free its pool slot
+                accountPool.destroy(accountToDelete);
+                sequence = journalAccountClosed(accountId);
             }
         }
     } catch (const std::exception& e) {
         std::cerr << "Error cleaning up deleted accounts: " << e.what() << std::endl;
     }
+    if (sequence > 0) {
+        journal.sync(sequence);
+    }
 }
 
-bool BankSystem::deposit(const std::string& accountId, double amount) {
-    Account* acc = findAccount(accountId);
-    if (acc == nullptr) return false;
-    
-    bool success = acc->deposit(amount);
-    if (success) {
+bool BankSystem::deposit(const std::string& accountId, Money amount) {
+    BANK_STATS_SCOPE(latencyStats, DEPOSIT);
+    if (isReadOnly()) return false;
+    uint64_t sequence;
+    {
+        AccountId id = AccountId::fromString(accountId);
+        AccountShard& shard = shardFor(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Account* acc = shard.accounts.find(id);
+        if (acc == nullptr) return false;
+
+        accrueInterest(acc, std::time(nullptr));
+        if (!acc->deposit(amount)) return false;
         // Add to global transactions
-        std::time_t now = std::time(nullptr);
-        std::string date = std::ctime(&now);
-        date.pop_back(); // Remove trailing newline
-        
-        std::string transId = "TXN";
-        std::random_device rd;
-        std::mt19937 generator(rd());
-        std::uniform_int_distribution<> distribution(0, 35);
-        
-        std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-        for (int i = 0; i < 8; ++i) {
-            transId += chars[distribution(generator)];
-        }
-        
-        allTransactions.push_back(Transaction(transId, accountId, "deposit", amount, date));
+        sequence = recordTransaction(acc, amount);
     }
-    
-    return success;
+
+    // Make it durable before reporting success; concurrent sessions share the fsync
+    return journal.sync(sequence);
 }
 
-bool BankSystem::withdraw(const std::string& accountId, double amount) {
-    Account* acc = findAccount(accountId);
-    if (acc == nullptr) return false;
-    
-    bool success = acc->withdraw(amount);
-    if (success) {
+bool BankSystem::withdraw(const std::string& accountId, Money amount) {
+    BANK_STATS_SCOPE(latencyStats, WITHDRAW);
+    if (isReadOnly()) return false;
+    uint64_t sequence;
+    {
+        AccountId id = AccountId::fromString(accountId);
+        AccountShard& shard = shardFor(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Account* acc = shard.accounts.find(id);
+        if (acc == nullptr) return false;
+
+        accrueInterest(acc, std::time(nullptr));
+        if (!acc->withdraw(amount)) return false;
         // Add to global transactions
-        std::time_t now = std::time(nullptr);
-        std::string date = std::ctime(&now);
-        date.pop_back(); // Remove trailing newline
-        
-        std::string transId = "TXN";
-        std::random_device rd;
-        std::mt19937 generator(rd());
-        std::uniform_int_distribution<> distribution(0, 35);
-        
-        std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-        for (int i = 0; i < 8; ++i) {
-            transId += chars[distribution(generator)];
+        sequence = recordTransaction(acc, amount);
+    }
+
+    // Make it durable before reporting success; concurrent sessions share the fsync
+    return journal.sync(sequence);
+}
+
+/**
+ * Headless bulk processing for end-of-day payment files.
+ * Account IDs are parsed once per operation and resolved through the flat
+ * account index, and the whole batch is made durable with a single journal
+ * sync at the end instead of one fsync per operation.
+ * Every shard stays locked for the duration of the batch; the password work
+ * (hashing new accounts' passwords, checking those of CLOSE entries) is done
+ * on the verification pool before that, as one run across its workers, and
+ * never under the locks: a CLOSE whose credential changed in the meantime is
+ * checked again with the locks released.
+ */
+size_t BankSystem::applyBatch(const std::vector<BatchOperation>& operations,
+                              std::vector<BatchResult>& results) {
+    BANK_STATS_SCOPE(latencyStats, APPLY_BATCH);
+    results.clear();
+    results.reserve(operations.size());
+    if (isReadOnly()) {
+        BatchResult refused;
+        refused.success = false;
+        refused.message = "not applied (the journal can't be written)";
+        for (const BatchOperation& op : operations) {
+            refused.accountId = op.accountId;
+            results.push_back(refused);
         }
-        
-        allTransactions.push_back(Transaction(transId, accountId, "withdrawal", amount, date));
+        return 0;
     }
-    
-    return success;
+
+    // Each ID is parsed once and resolved with a single flat-index probe
+    auto lookup = [&](const std::string& accountId) -> Account* {
+        AccountId id = AccountId::fromString(accountId);
+        return shardFor(id).accounts.find(id);
+    };
+
+    // Password work up front. A CLOSE is checked against the credential read here; if the
+    // account changed before the shard locks below, it is checked again without them.
+    // Like interactive logins, each CLOSE holds a loginThrottle token unless its password is right.
+    const size_t NO_JOB = static_cast<size_t>(-1);
+    std::vector<PasswordVerifier::Job> jobs;
+    std::vector<size_t> jobOf(operations.size(), NO_JOB);
+    std::vector<bool> throttled(operations.size(), false);
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const BatchOperation& op = operations[i];
+        PasswordVerifier::Job job;
+        job.password = op.password;
+        if (op.type == BatchOperation::CREATE) {
+            if (op.amount.isNegative() || !isSupportedAccountType(op.accountType)) continue;
+            job.type = PasswordVerifier::Job::HASH;
+            job.cost = passwordCost;
+        } else if (op.type == BatchOperation::CLOSE) {
+            if (!loginThrottle.tryAcquire()) {
+                throttled[i] = true;
+                continue;
+            }
+            AccountId id = AccountId::fromString(op.accountId);
+            AccountShard& shard = shardFor(id);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const Account* acc = shard.accounts.find(id);
+            if (acc == nullptr) continue;
+            job.type = PasswordVerifier::Job::VERIFY;
+            job.credential = acc->getPassword();
+        } else {
+            continue;
+        }
+        jobOf[i] = jobs.size();
+        jobs.push_back(job);
+    }
+    passwordVerifier.run(jobs);
+
+    // Numbers only for the CREATEs whose password was hashed, so none is taken and left unused
+    size_t creates = 0;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        if (operations[i].type == BatchOperation::CREATE && jobOf[i] != NO_JOB && !jobs[jobOf[i]].credential.empty()) {
+            ++creates;
+        }
+    }
+    std::vector<AccountId> newIds;
+    newIds.reserve(creates);
+    idAllocator.allocate(creates, newIds);
+    size_t nextNewId = 0;
+
+    // Lock every shard. A CLOSE whose account changed since its check (or appeared since) is
+    // verified again with the locks released, a few rounds at most; what is left fails below.
+    const int CLOSE_RECHECKS = 3;
+    auto locks = lockAllShards();
+    for (int attempt = 0; attempt < CLOSE_RECHECKS; ++attempt) {
+        std::vector<PasswordVerifier::Job> rechecks;
+        std::vector<size_t> recheckOf;
+        for (size_t i = 0; i < operations.size(); ++i) {
+            if (operations[i].type != BatchOperation::CLOSE || throttled[i]) continue;
+            const Account* acc = lookup(operations[i].accountId);
+            if (acc == nullptr || (jobOf[i] != NO_JOB && acc->getPassword() == jobs[jobOf[i]].credential)) continue;
+            PasswordVerifier::Job job;
+            job.type = PasswordVerifier::Job::VERIFY;
+            job.password = operations[i].password;
+            job.credential = acc->getPassword();
+            rechecks.push_back(job);
+            recheckOf.push_back(i);
+        }
+        if (rechecks.empty()) break;
+
+        locks.clear();
+        passwordVerifier.run(rechecks);
+        for (size_t k = 0; k < rechecks.size(); ++k) {
+            size_t i = recheckOf[k];
+            if (jobOf[i] == NO_JOB) {
+                jobOf[i] = jobs.size();
+                jobs.push_back(rechecks[k]);
+            } else {
+                jobs[jobOf[i]] = rechecks[k];
+            }
+        }
+        locks = lockAllShards();
+    }
+
+    size_t succeeded = 0;
+    bool failedClose = false;
+    std::time_t now = std::time(nullptr);
+
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const BatchOperation& op = operations[i];
+        const PasswordVerifier::Job* job = (jobOf[i] != NO_JOB) ? &jobs[jobOf[i]] : nullptr;
+        BatchResult result;
+        result.success = false;
+        result.accountId = op.accountId;
+        result.balance = Money();
+        result.message = "";
+
+        Account* acc = nullptr;
+        switch (op.type) {
+            case BatchOperation::DEPOSIT:
+            case BatchOperation::WITHDRAW: {
+                acc = lookup(op.accountId);
+                bool isDeposit = (op.type == BatchOperation::DEPOSIT);
+                if (acc == nullptr) {
+                    result.message = "account not found";
+                    break;
+                }
+                accrueInterest(acc, now);
+                if (isDeposit ? acc->deposit(op.amount) : acc->withdraw(op.amount)) {
+                    recordTransaction(acc, op.amount);
+                    result.success = true;
+                } else {
+                    result.message = isDeposit ? "invalid amount" : "insufficient funds or invalid amount";
+                }
+                break;
+            }
+            case BatchOperation::CREATE:
+                if (op.amount.isNegative()) {
+                    result.message = "invalid initial balance";
+                } else if (!isSupportedAccountType(op.accountType)) {
+                    result.message = "invalid account type";
+                } else if (job->credential.empty()) {
+                    result.message = "password could not be hashed";
+                } else if (nextNewId == newIds.size()) {
+                    result.message = "no account numbers left";
+                } else {
+                    AccountId id = newIds[nextNewId++];
+                    acc = openAccount(id, op.customerName, op.accountType, op.amount, job->credential, true);
+                    result.accountId = acc->getAccountId();
+                    result.success = true;
+                }
+                break;
+            case BatchOperation::CLOSE: {
+                acc = lookup(op.accountId);
+                bool checked = job != nullptr && acc != nullptr && acc->getPassword() == job->credential;
+                if (throttled[i]) {
+                    result.message = "too many failed logins; try again shortly";
+                } else if (acc == nullptr) {
+                    result.message = "account not found";
+                } else if (!checked) {
+                    // Its password kept changing while the batch waited for the locks
+                    result.message = "account changed during the batch; try again";
+                    loginThrottle.release();
+                } else if (!(acc->beginLogin() && acc->finishLogin(job->matched))) {
+                    result.message = "invalid password";
+                    failedClose = true;
+                } else {
+                    accrueInterest(acc, now);   // The closing balance includes the interest earned
+                    result.balance = acc->getBalance();
+                    AccountId id = AccountId::fromString(op.accountId);
+                    shardFor(id).accounts.erase(id);
+                    accountPool.destroy(acc);
+                    acc = nullptr;
+                    journalAccountClosed(op.accountId);
+                    loginThrottle.release();
+                    result.success = true;
+                }
+                break;
+            }
+            case BatchOperation::INVALID:
+                result.message = "unknown operation";
+                break;
+        }
+
+        if (result.success) {
+            if (acc != nullptr) result.balance = acc->getBalance();
+            ++succeeded;
+        }
+        results.push_back(result);
+    }
+
+    locks.clear();
+
+    // One fsync covers every record of the batch. If it fails, the journal drops the batch and the
+    // bank turns read-only (see isReadOnly), so what was applied in memory is never saved and
+    // resubmitting the batch after a restart applies it once
+    if (!journal.commit()) {
+        for (BatchResult& result : results) {
+            if (!result.success) continue;
+            result.success = false;
+            result.message = "not saved (journal write failed)";
+        }
+        succeeded = 0;
+    }
+
+    if (failedClose) {
+        cleanupDeletedAccounts();
+    }
+    return succeeded;
 }
 
+/**
+ * Accrues every savings account up to now, e.g. before month-end statements.
+ * Day-to-day operation doesn't need it: accounts accrue lazily when they are
+ * touched. Every shard stays locked, so it is atomic with respect to other
+ * sessions; one journal sync covers every accrual.
+ */
 void BankSystem::applyInterestToAllSavingsAccounts() {
-    for (auto& pair : accounts) {
-        if (pair.second->getAccountType() == "Savings") {
-            SavingsAccount* savingsAcc = static_cast<SavingsAccount*>(pair.second);
-            savingsAcc->applyInterest();
+    BANK_STATS_SCOPE(latencyStats, APPLY_INTEREST);
+    if (isReadOnly()) return;
+    {
+        auto locks = lockAllShards();
+        accrueAllSavingsAccounts(std::time(nullptr));
+    }
+    journal.commit();
+}
+
+bool BankSystem::isReadOnly() const {
+    return journal.isFailed();
+}
+
+size_t BankSystem::getShardCount() const {
+    return shards.size();
+}
+
+size_t BankSystem::getAccountCount() const {
+    size_t count = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        count += shard->accounts.size();
+    }
+    return count;
+}
+
+Money BankSystem::getTotalBalance() const {
+    auto locks = lockAllShards();
+    Money total;
+    for (const auto& shard : shards) {
+        shard->accounts.forEach([&](AccountId, Account* acc) {
+            total += acc->getBalance();
+        });
+    }
+    return total;
+}
+
+size_t BankSystem::getTransactionCount() const {
+    return allTransactions.size();
+}
+
+Money BankSystem::getInterestPosted() const {
+    return Money::fromCents(interestPostedCents.load());
+}
+
+BankSystem::PersistenceStats BankSystem::getPersistenceStats() const {
+    PersistenceStats stats;
+    {
+        std::lock_guard<std::mutex> lock(checkpointStatsMutex);
+        stats.checkpoints = checkpointCount;
+        stats.lastCheckpointSeconds = lastCheckpointSeconds;
+        stats.totalCheckpointSeconds = totalCheckpointSeconds;
+        stats.foldedJournalBytes = foldedJournalBytes;
+    }
+    stats.startupReplay = journal.getLastReplay();
+    stats.journalSegment = journal.getSegment();
+    stats.journalBytes = journal.getSize();
+    return stats;
+}
+
+void BankSystem::writeStats(std::ostream& out) const {
+#ifdef BANK_STATS
+    latencyStats.write(out);
+#else
+    out << "Operation statistics are not available (built with STATS=0)." << std::endl;
+#endif
+
+    PersistenceStats persistence = getPersistenceStats();
+    const Journal::ReplayStats& replay = persistence.startupReplay;
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1)
+        << "\nCheckpoints: " << persistence.checkpoints << " (last "
+        << persistence.lastCheckpointSeconds * 1e3 << " ms, total "
+        << persistence.totalCheckpointSeconds * 1e3 << " ms), "
+        << persistence.foldedJournalBytes << " journal bytes folded into snapshots\n"
+        << "Start-up replay: " << replay.records << " record(s), " << replay.bytes << " bytes in "
+        << replay.seconds * 1e3 << " ms (" << replay.skippedBytes << " bytes already in the snapshot)\n"
+        << "Journal: segment " << persistence.journalSegment << ", " << persistence.journalBytes << " bytes\n"
+        << "Login throttle: " << getThrottledLogins() << " attempt(s) turned away\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/**
+ * Reads one page of an account statement through the per-account chains of
+ * the transaction log, so the cost depends on the account's rows, not the
+ * ledger size. The page token is the log position of the next transaction.
+ */
+bool BankSystem::getStatement(const std::string& accountId, std::time_t fromTime, std::time_t toTime,
+                              const std::string& pageToken, StatementPage& page, size_t pageSize) const {
+    page.transactions.clear();
+    page.nextPageToken.clear();
+
+    AccountId id = AccountId::fromString(accountId);
+    if (!id.isValid() || pageSize == 0) return false;
+
+    size_t offset = TransactionLog::NO_OFFSET;
+    if (!pageToken.empty()) {
+        if (pageToken.find_first_not_of("0123456789") != std::string::npos || pageToken.size() > 18) {
+            return false;
         }
+        offset = static_cast<size_t>(std::stoull(pageToken));
+    }
+
+    page.transactions.reserve(pageSize);
+    size_t next = allTransactions.readAccount(id, fromTime, toTime, offset, pageSize, page.transactions);
+    if (next != TransactionLog::NO_OFFSET) {
+        page.nextPageToken = std::to_string(next);
     }
+    return true;
 }
 
 void BankSystem::displayAllAccounts() {
+    auto locks = lockAllShards();
+    accrueAllSavingsAccounts(std::time(nullptr));
+    std::vector<Account*> accounts = collectAccounts();
     if (accounts.empty()) {
         std::cout << "No accounts found." << std::endl;
         return;
@@ -268,13 +1407,11 @@ void BankSystem::displayAllAccounts() {
               << std::right << std::setw(12) << "Balance" << std::endl;
     std::cout << std::string(54, '-') << std::endl;
     
-    for (const auto& pair : accounts) {
-        Account* acc = pair.second;
+    for (const Account* acc : accounts) {
         std::cout << std::left << std::setw(12) << acc->getAccountId() 
                   << std::setw(20) << acc->getCustomerName() 
                   << std::setw(10) << acc->getAccountType() 
-                  << std::right << std::setw(12) << std::fixed << std::setprecision(2) 
-                  << acc->getBalance() << std::endl;
+                  << std::right << std::setw(12) << acc->getBalance() << std::endl;
     }
     std::cout << std::string(54, '-') << std::endl;
 }
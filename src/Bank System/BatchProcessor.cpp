@@ -0,0 +1,129 @@
+#include "../../include/Bank System/BatchProcessor.h"
+#include "../../include/utils/Algorithms.h"
+#include "../../include/utils/MappedFile.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+BatchOperation::Type parseOperationType(const FieldView& field) {
+    if (field.equals("deposit")) return BatchOperation::DEPOSIT;
+    if (field.equals("withdraw") || field.equals("withdrawal")) return BatchOperation::WITHDRAW;
+    if (field.equals("create")) return BatchOperation::CREATE;
+    if (field.equals("close")) return BatchOperation::CLOSE;
+    return BatchOperation::INVALID;
+}
+
+// Fills op in place so its strings keep their capacity from earlier chunks
+void parseOperation(const char* begin, const char* end, BatchOperation& op) {
+    FieldView fields[6];
+    size_t count = splitFields(begin, end, ',', fields, 6);
+
+    op.type = parseOperationType(fields[0]);
+    op.accountId.assign(count > 1 ? fields[1].data : begin, count > 1 ? fields[1].size : 0);
+    op.amount = Money();
+    if (count > 2 && fields[2].size > 0 && !Money::parse(fields[2].data, fields[2].size, op.amount)) {
+        op.type = BatchOperation::INVALID;
+    }
+    op.customerName.assign(count > 3 ? fields[3].data : begin, count > 3 ? fields[3].size : 0);
+    op.accountType.assign(count > 4 ? fields[4].data : begin, count > 4 ? fields[4].size : 0);
+    op.password.assign(count > 5 ? fields[5].data : begin, count > 5 ? fields[5].size : 0);
+}
+
+void appendResult(std::string& out, size_t lineNumber, const BatchResult& result) {
+    char number[64];
+    int length = std::snprintf(number, sizeof(number), "%zu,", lineNumber);
+    out.append(number, static_cast<size_t>(length));
+    out.append(result.success ? "OK," : "ERR,");
+    out.append(result.accountId);
+    out.push_back(',');
+    if (result.success) {
+        out.append(number, result.balance.format(number));
+    } else {
+        out.append(result.message);
+    }
+    out.push_back('\n');
+}
+
+} // namespace
+
+bool runBatchFile(BankSystem& bankSystem, const std::string& operationsFile,
+                  const std::string& resultsFile, size_t chunkSize) {
+    MappedFile file;
+    if (!file.open(operationsFile)) {
+        std::cerr << "Cannot open batch file " << operationsFile << std::endl;
+        return false;
+    }
+
+    std::ofstream results(resultsFile, std::ios::binary | std::ios::trunc);
+    if (!results.is_open()) {
+        std::cerr << "Cannot create results file " << resultsFile << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Buffers reused by every chunk
+    std::vector<BatchOperation> operations(chunkSize);
+    std::vector<size_t> lineNumbers(chunkSize);
+    std::vector<BatchResult> outcomes;
+    std::string output;
+
+    size_t pending = 0;
+    size_t total = 0;
+    size_t succeeded = 0;
+
+    auto flushChunk = [&]() {
+        if (pending == 0) return;
+        operations.resize(pending);
+        succeeded += bankSystem.applyBatch(operations, outcomes);
+
+        output.clear();
+        for (size_t i = 0; i < outcomes.size(); ++i) {
+            appendResult(output, lineNumbers[i], outcomes[i]);
+        }
+        results.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+        total += pending;
+        pending = 0;
+        operations.resize(chunkSize);
+    };
+
+    const char* cursor = file.data();
+    const char* end = cursor + file.size();
+    size_t lineNumber = 0;
+
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        if (lineEnd == nullptr) lineEnd = end;
+        const char* contentEnd = lineEnd;
+        if (contentEnd > cursor && contentEnd[-1] == '\r') --contentEnd;
+        ++lineNumber;
+
+        if (contentEnd > cursor && *cursor != '#') {
+            parseOperation(cursor, contentEnd, operations[pending]);
+            lineNumbers[pending] = lineNumber;
+            if (++pending == chunkSize) flushChunk();
+        }
+        cursor = lineEnd + 1;
+    }
+    flushChunk();
+    results.close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Batch complete: " << succeeded << " of " << total << " operations succeeded in "
+              << seconds << "s";
+    if (seconds > 0) {
+        std::cout << " (" << static_cast<long long>(total / seconds) << " ops/sec)";
+    }
+    std::cout << std::endl;
+    if (bankSystem.isReadOnly()) {
+        std::cerr << "The journal could not be written; operations from the first failed chunk on were not applied"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,133 @@
+#include "../../include/Bank System/TransactionLog.h"
+#include <algorithm>
+
+namespace {
+
+const uint32_t NO_ROW = UINT32_MAX;   // End of a chain
+const size_t INITIAL_CHAINS = 1024;
+
+} // namespace
+
+TransactionLog::TransactionLog() : chainCount(0), indexedCount(0) {
+    Chain empty = {AccountId::INVALID, NO_ROW, NO_ROW, 0, NO_ROW};
+    chains.assign(INITIAL_CHAINS, empty);
+}
+
+// Fibonacci hashing, as in AccountIndex
+size_t TransactionLog::home(uint32_t key) const {
+    return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32) & (chains.size() - 1);
+}
+
+const TransactionLog::Chain* TransactionLog::findChain(uint32_t key) const {
+    size_t mask = chains.size() - 1;
+    for (size_t i = home(key);; i = (i + 1) & mask) {
+        if (chains[i].key == key) return &chains[i];
+        if (chains[i].key == AccountId::INVALID) return nullptr;
+    }
+}
+
+void TransactionLog::growChains() {
+    std::vector<Chain> old;
+    old.swap(chains);
+    Chain empty = {AccountId::INVALID, NO_ROW, NO_ROW, 0, NO_ROW};
+    chains.assign(old.size() * 2, empty);
+    size_t mask = chains.size() - 1;
+    for (const Chain& chain : old) {
+        if (chain.key == AccountId::INVALID) continue;
+        size_t i = home(chain.key);
+        while (chains[i].key != AccountId::INVALID) {
+            i = (i + 1) & mask;
+        }
+        chains[i] = chain;
+    }
+}
+
+// Links each new row to the end of its account's chain
+void TransactionLog::indexNewEntries() {
+    nextInAccount.reserve(entries.capacity());
+    nextInAccount.resize(entries.size(), NO_ROW);
+    for (; indexedCount < entries.size(); ++indexedCount) {
+        uint32_t row = static_cast<uint32_t>(indexedCount);
+        uint32_t key = entries[indexedCount].getAccountId().getValue();
+        if (key == AccountId::INVALID) continue;   // No statement can ask for it
+
+        // Keep the load factor at or below 1/2 so probe runs stay short
+        if ((chainCount + 1) * 2 > chains.size()) growChains();
+        size_t mask = chains.size() - 1;
+        size_t i = home(key);
+        while (chains[i].key != key && chains[i].key != AccountId::INVALID) {
+            i = (i + 1) & mask;
+        }
+        Chain& chain = chains[i];
+        if (chain.key == key) {
+            nextInAccount[chain.last] = row;
+            chain.last = row;
+            if (chain.length % SKIP_EVERY == 0) {
+                if (chain.skips == NO_ROW) {
+                    chain.skips = static_cast<uint32_t>(skipLists.size());
+                    skipLists.push_back(std::vector<uint32_t>());
+                }
+                skipLists[chain.skips].push_back(row);
+            }
+            ++chain.length;
+        } else {
+            chain.key = key;
+            chain.first = row;
+            chain.last = row;
+            chain.length = 1;
+            ++chainCount;
+        }
+    }
+}
+
+// The skip rows before fromTime are a prefix of the account's list, so the last of them is
+// found by binary search; the walk from there passes fewer than SKIP_EVERY rows
+uint32_t TransactionLog::firstRowFrom(const Chain& chain, std::time_t fromTime) const {
+    uint32_t row = chain.first;
+    if (chain.skips != NO_ROW) {
+        const std::vector<uint32_t>& skips = skipLists[chain.skips];
+        std::vector<uint32_t>::const_iterator after = std::lower_bound(
+            skips.begin(), skips.end(), fromTime,
+            [this](uint32_t skip, std::time_t time) { return entries[skip].getTimestamp() < time; });
+        if (after != skips.begin()) row = *(after - 1);
+    }
+    while (row != NO_ROW && entries[row].getTimestamp() < fromTime) {
+        row = nextInAccount[row];
+    }
+    return row;
+}
+
+size_t TransactionLog::append(const Transaction& transaction) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.push_back(transaction);
+    indexNewEntries();
+    return entries.size() - 1;
+}
+
+size_t TransactionLog::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t TransactionLog::readAccount(AccountId accountId, std::time_t fromTime, std::time_t toTime,
+                                   size_t offset, size_t maxCount, std::vector<Transaction>& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t row;
+    if (offset == NO_OFFSET) {
+        const Chain* chain = findChain(accountId.getValue());
+        if (chain == nullptr) return NO_OFFSET;
+        row = firstRowFrom(*chain, fromTime);
+    } else {
+        if (offset >= indexedCount || entries[offset].getAccountId() != accountId) return NO_OFFSET;
+        row = static_cast<uint32_t>(offset);
+    }
+
+    for (; row != NO_ROW; row = nextInAccount[row]) {
+        const Transaction& trans = entries[row];
+        if (trans.getTimestamp() > toTime) return NO_OFFSET;
+        if (maxCount == 0) return row;
+        out.push_back(trans);
+        --maxCount;
+    }
+    return NO_OFFSET;
+}
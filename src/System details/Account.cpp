@@ -1,12 +1,21 @@
 #include "../../include/System details/Account.h"
+#include "../../include/System details/CheckingAccount.h"
+#include "../../include/System details/SavingsAccount.h"
+#include "../../include/utils/Algorithms.h"
+#include "../../include/utils/CsvWriter.h"
+#include "../../include/utils/PasswordHash.h"
 #include <ctime>
-#include <random>
 
 Account::Account(const std::string& id, const std::string& name, const std::string& type, 
-                double initialBalance, const std::string& pwd)
-    : accountId(id), customerName(name), accountType(type), 
-      balance(initialBalance), password(pwd), locked(false), lockoutTime(0) {
-    // The stack and queue are automatically initialized
+                Money initialBalance, const std::string& pwd)
+    : Account(BASIC, id, name, type, initialBalance, pwd) {}
+
+Account::Account(Kind kind, const std::string& id, const std::string& name, const std::string& type,
+                 Money initialBalance, const std::string& pwd)
+    : kind(kind), accountId(id), customerName(name), accountType(type), 
+      balance(initialBalance), password(pwd), lockedUntil(0), nextFailure(0), failureCount(0),
+      markedForDeletion(false) {
+    // The queue is automatically initialized; the failure ring is only read up to failureCount
 }
 
 std::string Account::getAccountId() const { 
@@ -17,11 +26,11 @@ std::string Account::getCustomerName() const {
     return customerName; 
 }
 
-std::string Account::getAccountType() const { 
+const std::string& Account::getAccountType() const { 
     return accountType; 
 }
 
-double Account::getBalance() const { 
+Money Account::getBalance() const { 
     return balance; 
 }
 
@@ -29,17 +38,33 @@ std::string Account::getPassword() const {
     return password; 
 }
 
+void Account::restoreBalance(Money newBalance) {
+    balance = newBalance;
+}
+
 bool Account::isLocked() const {
-    return locked;
+    return markedForDeletion || static_cast<std::time_t>(lockedUntil) > std::time(nullptr);
 }
 
 int Account::getLockoutTime() const {
-    return lockoutTime;
+    if (markedForDeletion) return 999999; // Effectively permanent
+    std::time_t remaining = static_cast<std::time_t>(lockedUntil) - std::time(nullptr);
+    return remaining > 0 ? static_cast<int>(remaining) : 0;
 }
 
 bool Account::shouldBeDeleted() const {
-    // Account should be deleted if it has 5 or more failed login attempts
-    return (failedAttempts.size() >= 5);
+    // Account should be deleted once 5 failed login attempts fell within one window
+    return markedForDeletion;
+}
+
+uint8_t Account::recentFailures(std::time_t now) const {
+    uint8_t recent = 0;
+    for (uint8_t i = 0; i < failureCount; ++i) {
+        if (now - static_cast<std::time_t>(failureTimes[i]) < static_cast<std::time_t>(FAILURE_WINDOW_SECONDS)) {
+            ++recent;
+        }
+    }
+    return recent;
 }
 
 /**
@@ -49,20 +74,37 @@ bool Account::shouldBeDeleted() const {
  * - Account deletion after 5 failed attempts
  * - Failed attempt tracking even when the account is already locked
  *
+ * The stored credential is a salted hash (PasswordHash), so this runs the KDF
+ * on the calling thread; BankSystem uses beginLogin()/finishLogin() instead and
+ * hashes on its verification pool without the account lock held.
  */
 bool Account::validatePassword(const std::string& pwd) {
+    return beginLogin() && finishLogin(PasswordHash::verify(pwd, password));
+}
+
+// Refuses (and counts) a login attempt while the account is locked
+bool Account::beginLogin() {
     try {
         // First check and display the lock status to the user
         checkLockStatus();
         
-        if (locked) {
+        if (isLocked()) {
             //NOTE: Even though the account is locked, we still count this as a failed attempt
             recordFailedAttempt();
             return false;
         }
-        
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error validating password: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// A correct password still fails if other attempts locked the account while it was being checked
+bool Account::finishLogin(bool matched) {
+    try {
         // If password is correct, reset all failed attempts and unlock the account
-        if (pwd == password) {
+        if (matched && !isLocked()) {
             resetFailedAttempts();
             return true;
         } else {
@@ -76,56 +118,52 @@ bool Account::validatePassword(const std::string& pwd) {
     }
 }
 
+void Account::setPassword(const std::string& credential) {
+    password = credential;
+}
+
 /**
  * Records a failed login attempt and updates the account's security status
- * Implements a progressive security protocol:
+ * Implements a progressive security protocol, counting the failures of the
+ * last FAILURE_WINDOW_SECONDS (older ones expire):
  * - First 2 attempts: Warning only
  * - 3 attempts: Account locked for 1 minute
- * - 4 attempts: Final warning, account still locked
- * - 5+ attempts: Account marked for deletion
- * 
- * Using a stack to track attempts allows for potential future features like
- * time-based attempt expiration or more sophisticated security analytics.
+ * - 4 attempts: Final warning, account locked for another minute
+ * - 5 attempts: Account marked for deletion
+ *
+ * The attempts are kept as timestamps in a ring of the last five, so the
+ * state has a fixed size however many failures an account receives.
  */
 void Account::recordFailedAttempt() {
-    try {
-        // Push a new failed attempt onto the stack (value 1 is arbitrary, could track timestamp instead)
-        failedAttempts.push(1);
-        
-        // Get the total number of failed attempts
-        int attempts = failedAttempts.size();
-        
-        // Set locked status and lockout time based on number of failed attempts
-        if (attempts < 3) {
-            // First 2 attempts: Warning only
-            lockoutTime = 0;
-            locked = false;
-            std::cout << "Warning: Failed login attempt " << attempts << " of 3 before temporary lockout." << std::endl;
-        } else if (attempts == 3) {
-            // 3 attempts: Lock for 1 minute (60 seconds)
-            lockoutTime = 60;
-            locked = true;
+    std::time_t now = std::time(nullptr);
+    failureTimes[nextFailure] = static_cast<uint32_t>(now);
+    nextFailure = static_cast<uint8_t>((nextFailure + 1) % DELETE_AFTER_FAILURES);
+    if (failureCount < DELETE_AFTER_FAILURES) ++failureCount;
+
+    // Get the number of failed attempts that still count
+    int attempts = recentFailures(now);
+
+    // Set the lock time based on number of failed attempts
+    if (attempts < LOCK_AFTER_FAILURES) {
+        // First 2 attempts: Warning only
+        std::cout << "Warning: Failed login attempt " << attempts << " of 3 before temporary lockout." << std::endl;
+    } else if (attempts < DELETE_AFTER_FAILURES) {
+        // 3 or 4 attempts: Lock for 1 minute (60 seconds) from now
+        lockedUntil = static_cast<uint32_t>(now + LOCKOUT_SECONDS);
+        if (attempts == LOCK_AFTER_FAILURES) {
             std::cout << "WARNING: Account locked for 1 minute due to 3 failed login attempts." << std::endl;
             std::cout << "After 5 failed attempts, your account will be DELETED for security reasons." << std::endl;
-        } else if (attempts == 4) {
+        } else {
             // 4 attempts: Last warning before deletion
-            lockoutTime = 60;
-            locked = true;
             std::cout << "CRITICAL WARNING: This is your LAST attempt before account deletion!" << std::endl;
             std::cout << "Account remains locked for 1 minute." << std::endl;
-        } else if (attempts >= 5) {
-            // 5 or more attempts: Mark for deletion
-            lockoutTime = 999999; // Effectively permanent
-            locked = true;
-            std::cout << "ACCOUNT SECURITY BREACH: Your account has been marked for DELETION due to " 
-                    << "multiple failed login attempts." << std::endl;
-            std::cout << "Please contact customer support if this was a mistake." << std::endl;
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Error recording failed attempt: " << e.what() << std::endl;
-        // Ensure account is still secured even if there's an error
-        locked = true;
-        lockoutTime = 60;
+    } else if (!markedForDeletion) {
+        // 5 attempts: Mark for deletion
+        markedForDeletion = true;
+        std::cout << "ACCOUNT SECURITY BREACH: Your account has been marked for DELETION due to " 
+                << "multiple failed login attempts." << std::endl;
+        std::cout << "Please contact customer support if this was a mistake." << std::endl;
     }
 }
 
@@ -134,113 +172,121 @@ void Account::recordFailedAttempt() {
  * Called when a user successfully authenticates with the correct password
  */
 void Account::resetFailedAttempts() {
-    try {
-        // Clear all failed attempts from the stack by popping them one by one
-        while (!failedAttempts.empty()) {
-            failedAttempts.pop();
-        }
-        
-        // Reset the account security state to default (unlocked)
-        locked = false;
-        lockoutTime = 0;
-    } catch (const std::exception& e) {
-        std::cerr << "Error resetting failed attempts: " << e.what() << std::endl;
-        // Ensure account is unlocked even if there's an error with the stack operations
-        locked = false;
-        lockoutTime = 0;
-    }
+    nextFailure = 0;
+    failureCount = 0;
+    lockedUntil = 0;
+    markedForDeletion = false;
 }
 
 /**
  * Checks and displays the current lock status of the account
  * Provides user feedback about:
  * - Whether the account is locked
- * - How long the lockout period is
+ * - How long the lockout has left to run
  * - How many attempts remain before account deletion
  */
 void Account::checkLockStatus() {
-    try {
-        // First check if account is already marked for deletion (5+ failed attempts)
-        if (locked && failedAttempts.size() >= 5) {
-            std::cout << "This account has been marked for deletion due to security concerns." << std::endl;
-            std::cout << "Please contact customer support for assistance." << std::endl;
-            return;
-        }
-        
-        // If account is temporarily locked (3-4 failed attempts), display lockout info
-        if (locked) {
-            std::cout << "Account is temporarily locked due to multiple failed login attempts." << std::endl;
-            std::cout << "Please try again after " << lockoutTime << " seconds." << std::endl;
-            
-            // Calculate and display remaining attempts before account deletion
-            // Formula: 5 (max attempts) - current attempts = remaining attempts
-            int remainingAttempts = 5 - static_cast<int>(failedAttempts.size());
-            if (remainingAttempts < 0) remainingAttempts = 0;
-            
-            std::cout << "Remaining attempts before deletion: " << remainingAttempts << std::endl;
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Error checking lock status: " << e.what() << std::endl;
+    // First check if account is already marked for deletion (5 failed attempts)
+    if (markedForDeletion) {
+        std::cout << "This account has been marked for deletion due to security concerns." << std::endl;
+        std::cout << "Please contact customer support for assistance." << std::endl;
+        return;
+    }
+
+    // If account is temporarily locked (3-4 failed attempts), display lockout info
+    int lockoutTime = getLockoutTime();
+    if (lockoutTime > 0) {
+        std::cout << "Account is temporarily locked due to multiple failed login attempts." << std::endl;
+        std::cout << "Please try again after " << lockoutTime << " seconds." << std::endl;
+
+        // Calculate and display remaining attempts before account deletion
+        // Formula: 5 (max attempts) - recent attempts = remaining attempts
+        int remainingAttempts = DELETE_AFTER_FAILURES - recentFailures(std::time(nullptr));
+        if (remainingAttempts < 0) remainingAttempts = 0;
+
+        std::cout << "Remaining attempts before deletion: " << remainingAttempts << std::endl;
     }
 }
 
-bool Account::deposit(double amount) {
-    if (amount <= 0) return false;
-    
-    balance += amount;
+bool Account::deposit(Money amount) {
+    // Refuse the deposit rather than wrap the balance around
+    if (!amount.isPositive() || !balance.tryAdd(amount, balance)) return false;
     
     // Create transaction record
-    std::time_t now = std::time(nullptr);
-    std::string date = std::ctime(&now);
-    date.pop_back(); // Remove trailing newline
-    
-    Transaction trans(generateTransactionId(), accountId, "deposit", amount, date);
-    recentTransactions.push(trans);
-    
-    while (recentTransactions.size() > 10) {
-        recentTransactions.pop();
-    }
-    
+    rememberTransaction(Transaction(TransactionId::generate(), AccountId::fromString(accountId),
+                                    Transaction::DEPOSIT, amount, std::time(nullptr)));
+    return true;
+}
+
+bool Account::postDeposit(const Transaction& trans) {
+    Money amount = trans.getAmount();
+    if (!amount.isPositive() || !balance.tryAdd(amount, balance)) return false;
+    rememberTransaction(trans);
     return true;
 }
 
-bool Account::withdraw(double amount) {
-    if (amount <= 0 || amount > balance) return false;
+bool Account::withdraw(Money amount) {
+    if (!amount.isPositive()) return false;
+    if (kind == CHECKING) {
+        // Add transaction fee
+        Money fee = static_cast<const CheckingAccount*>(this)->getTransactionFee();
+        if (!amount.tryAdd(fee, amount)) return false;
+    }
+    if (amount > balance) return false;
     
     balance -= amount;
     
     // Create transaction record
-    std::time_t now = std::time(nullptr);
-    std::string date = std::ctime(&now);
-    date.pop_back(); // Remove trailing newline
-    
-    Transaction trans(generateTransactionId(), accountId, "withdrawal", amount, date);
+    rememberTransaction(Transaction(TransactionId::generate(), AccountId::fromString(accountId),
+                                    Transaction::WITHDRAWAL, amount, std::time(nullptr)));
+    return true;
+}
+
+void Account::rememberTransaction(const Transaction& trans) {
     recentTransactions.push(trans);
     
     while (recentTransactions.size() > 10) {
         recentTransactions.pop();
     }
-    
-    return true;
 }
 
-std::string Account::toCSV() const {
-    return accountId + "," + customerName + "," + accountType + "," + 
-            std::to_string(balance) + "," + password;
+const Transaction& Account::getLastTransaction() const {
+    return recentTransactions.back();
 }
 
-std::string Account::generateTransactionId() const {
-    // Simple transaction ID generator
-    std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    std::string id = "TXN";
-    
-    std::random_device rd;
-    std::mt19937 generator(rd());
-    std::uniform_int_distribution<> distribution(0, chars.size() - 1);
-
-    for (int i = 0; i < 8; ++i) {
-        id += chars[distribution(generator)];
+void Account::writeCSV(CsvWriter& out) const {
+    out.put(accountId);
+    out.put(',');
+    out.put(customerName);
+    out.put(',');
+    out.put(accountType);
+    out.put(',');
+    out.putFormatted(balance);
+    out.put(',');
+    out.put(password);
+    switch (kind) {
+        case CHECKING:
+            out.put(',');
+            out.putFormatted(static_cast<const CheckingAccount*>(this)->getTransactionFee());
+            break;
+        case SAVINGS:
+        {
+            const SavingsAccount* savings = static_cast<const SavingsAccount*>(this);
+            out.put(',');
+            out.putFormatted(savings->getInterestRate());
+            out.put(',');
+            out.putInteger(static_cast<int64_t>(savings->getAccruedThrough()));
+            out.put(',');
+            out.putInteger(savings->getAccrualCarry());
+            break;
+        }
+        case BASIC:
+            break;
     }
-    
-    return id;
-}
\ No newline at end of file
+}
+
+std::string Account::toCSV() const {
+    CsvWriter line;
+    writeCSV(line);
+    return line.str();
+}
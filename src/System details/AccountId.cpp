@@ -0,0 +1,47 @@
+#include "../../include/System details/AccountId.h"
+
+AccountId AccountId::fromString(const std::string& text) {
+    return fromString(text.data(), text.size());
+}
+
+AccountId AccountId::fromString(const char* text, size_t length) {
+    // "ACC" + 5..9 digits; more than 5 digits must not start with 0 so every
+    // number has exactly one text form
+    if (length < 8 || length > 12 || text[0] != 'A' || text[1] != 'C' || text[2] != 'C') {
+        return AccountId();
+    }
+    if (length > 8 && text[3] == '0') {
+        return AccountId();
+    }
+
+    uint32_t number = 0;
+    for (size_t i = 3; i < length; ++i) {
+        if (text[i] < '0' || text[i] > '9') return AccountId();
+        number = number * 10 + static_cast<uint32_t>(text[i] - '0');
+    }
+    return AccountId(number);
+}
+
+size_t AccountId::format(char* out) const {
+    char digits[10];
+    size_t count = 0;
+    uint32_t number = value;
+    do {
+        digits[count++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    while (count < 5) digits[count++] = '0';
+
+    out[0] = 'A';
+    out[1] = 'C';
+    out[2] = 'C';
+    for (size_t i = 0; i < count; ++i) {
+        out[3 + i] = digits[count - 1 - i];
+    }
+    return 3 + count;
+}
+
+std::string AccountId::toString() const {
+    char buffer[MAX_TEXT_LENGTH];
+    return std::string(buffer, format(buffer));
+}
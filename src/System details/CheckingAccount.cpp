@@ -1,14 +1,9 @@
 #include "../../include/System details/CheckingAccount.h"
 
-CheckingAccount::CheckingAccount(const std::string& id, const std::string& name, double initialBalance, 
-                                const std::string& pwd, double fee)
-    : Account(id, name, "Checking", initialBalance, pwd), transactionFee(fee) {}
+CheckingAccount::CheckingAccount(const std::string& id, const std::string& name, Money initialBalance, 
+                                const std::string& pwd, Money fee)
+    : Account(CHECKING, id, name, "Checking", initialBalance, pwd), transactionFee(fee) {}
 
-bool CheckingAccount::withdraw(double amount) {
-    // Add transaction fee
-    return Account::withdraw(amount + transactionFee);
+Money CheckingAccount::getTransactionFee() const {
+    return transactionFee;
 }
-
-std::string CheckingAccount::toCSV() const {
-    return Account::toCSV() + "," + std::to_string(transactionFee);
-}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "../../include/System details/Money.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const int64_t POWERS_OF_TEN[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+// Whether magnitude should be bumped by one unit, given the first dropped digit and
+// whether any digit after it was non-zero
+bool roundsUp(uint64_t magnitude, int droppedDigit, bool droppedRest, RoundingMode mode) {
+    switch (mode) {
+        case ROUND_DOWN:
+            return false;
+        case ROUND_HALF_UP:
+            return droppedDigit >= 5;
+        case ROUND_HALF_EVEN:
+        default:
+            return droppedDigit > 5 || (droppedDigit == 5 && (droppedRest || (magnitude & 1) != 0));
+    }
+}
+
+/**
+ * Parses a plain decimal into an integer count of 10^-decimals units without
+ * going through floating point. Digits past the scale are rounded with mode.
+ */
+bool parseFixed(const char* text, size_t length, int decimals, RoundingMode mode, int64_t& value) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < length && (text[i] == '-' || text[i] == '+')) {
+        negative = (text[i] == '-');
+        ++i;
+    }
+
+    const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    uint64_t magnitude = 0;
+    int fractionDigits = 0;
+    int droppedDigit = -1;
+    bool droppedRest = false;
+    bool inFraction = false;
+    bool anyDigit = false;
+
+    for (; i < length; ++i) {
+        char c = text[i];
+        if (c == '.' && !inFraction) {
+            inFraction = true;
+            continue;
+        }
+        if (c < '0' || c > '9') return false;
+        anyDigit = true;
+        int digit = c - '0';
+
+        if (inFraction && fractionDigits == decimals) {
+            // Past the scale: remember what's needed for rounding
+            if (droppedDigit < 0) {
+                droppedDigit = digit;
+            } else if (digit != 0) {
+                droppedRest = true;
+            }
+            continue;
+        }
+        if (magnitude > (limit - static_cast<uint64_t>(digit)) / 10) return false;
+        magnitude = magnitude * 10 + static_cast<uint64_t>(digit);
+        if (inFraction) ++fractionDigits;
+    }
+    if (!anyDigit) return false;
+
+    for (; fractionDigits < decimals; ++fractionDigits) {
+        if (magnitude > limit / 10) return false;
+        magnitude *= 10;
+    }
+    if (droppedDigit >= 0 && roundsUp(magnitude, droppedDigit, droppedRest, mode)) {
+        if (magnitude == limit) return false;
+        ++magnitude;
+    }
+
+    value = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+    return true;
+}
+
+size_t formatFixed(int64_t value, int decimals, char* out) {
+    uint64_t magnitude = (value < 0) ? 0ull - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+
+    // Digits are produced backwards into a scratch buffer
+    char digits[24];
+    size_t count = 0;
+    for (int i = 0; i < decimals; ++i) {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    digits[count++] = '.';
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    size_t length = 0;
+    if (value < 0) out[length++] = '-';
+    while (count > 0) {
+        out[length++] = digits[--count];
+    }
+    return length;
+}
+
+} // namespace
+
+Money Money::fromDouble(double amount) {
+    return Money(static_cast<int64_t>(std::llround(amount * 100.0)));
+}
+
+bool Money::parse(const char* text, size_t length, Money& amount, RoundingMode mode) {
+    int64_t value;
+    if (!parseFixed(text, length, DECIMALS, mode, value)) return false;
+    amount = Money(value);
+    return true;
+}
+
+bool Money::parse(const std::string& text, Money& amount, RoundingMode mode) {
+    return parse(text.data(), text.size(), amount, mode);
+}
+
+size_t Money::format(char* out) const {
+    return formatFixed(cents, DECIMALS, out);
+}
+
+std::string Money::toString() const {
+    char buffer[MAX_TEXT_LENGTH];
+    return std::string(buffer, format(buffer));
+}
+
+bool Money::tryAdd(Money other, Money& result) const {
+    int64_t sum;
+    if (__builtin_add_overflow(cents, other.cents, &sum)) return false;
+    result = Money(sum);
+    return true;
+}
+
+bool Money::trySubtract(Money other, Money& result) const {
+    int64_t difference;
+    if (__builtin_sub_overflow(cents, other.cents, &difference)) return false;
+    result = Money(difference);
+    return true;
+}
+
+Money Money::operator+(Money other) const {
+    Money result;
+    if (!tryAdd(other, result)) throw std::overflow_error("Money addition overflow");
+    return result;
+}
+
+Money Money::operator-(Money other) const {
+    Money result;
+    if (!trySubtract(other, result)) throw std::overflow_error("Money subtraction overflow");
+    return result;
+}
+
+Money& Money::operator+=(Money other) {
+    *this = *this + other;
+    return *this;
+}
+
+Money& Money::operator-=(Money other) {
+    *this = *this - other;
+    return *this;
+}
+
+std::ostream& operator<<(std::ostream& out, Money amount) {
+    return out << amount.toString();
+}
+
+InterestRate InterestRate::fromDouble(double rate) {
+    return InterestRate(static_cast<int64_t>(std::llround(rate * SCALE)));
+}
+
+bool InterestRate::parse(const char* text, size_t length, InterestRate& rate) {
+    int64_t value;
+    if (!parseFixed(text, length, DECIMALS, ROUND_HALF_EVEN, value)) return false;
+    rate = InterestRate(value);
+    return true;
+}
+
+size_t InterestRate::format(char* out) const {
+    return formatFixed(micros, DECIMALS, out);
+}
+
+std::string InterestRate::toString() const {
+    char buffer[Money::MAX_TEXT_LENGTH + 8];
+    return std::string(buffer, format(buffer));
+}
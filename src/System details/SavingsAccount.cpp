@@ -1,14 +1,92 @@
 #include "../../include/System details/SavingsAccount.h"
+#include <algorithm>
+#include <limits>
 
-SavingsAccount::SavingsAccount(const std::string& id, const std::string& name, double initialBalance, 
-                              const std::string& pwd, double rate)
-    : Account(id, name, "Savings", initialBalance, pwd), interestRate(rate) {}
+SavingsAccount::SavingsAccount(const std::string& id, const std::string& name, Money initialBalance,
+                              const std::string& pwd, InterestRate rate,
+                              std::time_t accruedThrough, int64_t accrualCarry)
+    : Account(SAVINGS, id, name, "Savings", initialBalance, pwd), interestRate(rate),
+      accruedThrough(accruedThrough != 0 ? accruedThrough : std::time(nullptr)), accrualCarry(accrualCarry) {}
 
-void SavingsAccount::applyInterest() {
-    double interest = getBalance() * interestRate;
-    deposit(interest);
+InterestRate SavingsAccount::getInterestRate() const {
+    return interestRate;
 }
 
-std::string SavingsAccount::toCSV() const {
-    return Account::toCSV() + "," + std::to_string(interestRate);
-}
\ No newline at end of file
+std::time_t SavingsAccount::getAccruedThrough() const {
+    return accruedThrough;
+}
+
+int64_t SavingsAccount::getAccrualCarry() const {
+    return accrualCarry;
+}
+
+int64_t SavingsAccount::accrualDays(std::time_t now) const {
+    if (now <= accruedThrough) return 0;
+    return static_cast<int64_t>(now - accruedThrough) / SECONDS_PER_DAY;
+}
+
+void SavingsAccount::restoreAccrual(std::time_t newAccruedThrough, int64_t newCarry) {
+    accruedThrough = newAccruedThrough;
+    accrualCarry = newCarry;
+}
+
+/**
+ * Exponentiation by squaring in 10^-18 fixed point, so any number of days
+ * costs O(log days) multiplications. Values are capped at 2^64 - 1 (a factor
+ * of about 18.4) which keeps every product inside 128 bits.
+ */
+int64_t SavingsAccount::growthFor(InterestRate rate, int64_t days) {
+    if (days <= 0 || rate.getMicros() <= 0) return 0;
+
+    typedef unsigned __int128 Fixed;
+    const Fixed one = static_cast<Fixed>(1000000000000000000ULL);
+    const Fixed limit = static_cast<Fixed>(std::numeric_limits<uint64_t>::max());
+
+    Fixed base = one + static_cast<Fixed>(rate.getMicros()) * (one / InterestRate::SCALE) / DAYS_PER_YEAR;
+    base = std::min(base, limit);
+    Fixed factor = one;
+    while (true) {
+        if (days & 1) factor = std::min(factor * base / one, limit);
+        days >>= 1;
+        if (days == 0) break;
+        base = std::min(base * base / one, limit);
+    }
+    return static_cast<int64_t>((factor - one) / (one / GROWTH_SCALE));
+}
+
+/**
+ * interest = balance * growth, truncated to millionths of a cent, plus the
+ * previous carry; whole cents are posted and the rest is carried. Accounts
+ * without a positive balance just move their accrual time forward.
+ * InterestEngine::computeAccrual performs the same integer steps.
+ */
+bool SavingsAccount::accrueInterest(std::time_t now, Money& interest) {
+    int64_t days = accrualDays(now);
+    if (days <= 0) return false;
+
+    int64_t cents = getBalance().getCents();
+    int64_t interestCents = 0;
+    int64_t carry = accrualCarry;
+    if (cents > 0) {
+        __int128 total = static_cast<__int128>(cents) * growthFor(interestRate, days) / (GROWTH_SCALE / CARRY_SCALE)
+                         + carry;
+        __int128 whole = total / CARRY_SCALE;
+        interestCents = static_cast<int64_t>(std::min<__int128>(whole, std::numeric_limits<int64_t>::max()));
+        carry = static_cast<int64_t>(total % CARRY_SCALE);
+    }
+    settleAccrual(days, interestCents, carry, interest);
+    return true;
+}
+
+void SavingsAccount::settleAccrual(int64_t days, int64_t interestCents, int64_t carry, Money& interest) {
+    accruedThrough += static_cast<std::time_t>(days * SECONDS_PER_DAY);
+    accrualCarry = carry;
+    interest = Money();
+    if (interestCents <= 0) return;
+
+    Transaction posting(TransactionId::generate(), AccountId::fromString(accountId), Transaction::DEPOSIT,
+                        Money::fromCents(interestCents), accruedThrough);
+    if (postDeposit(posting)) {
+        interest = posting.getAmount();
+    }
+}
@@ -1,30 +1,80 @@
 #include "../../include/System details/Transaction.h"
+#include "../../include/utils/Algorithms.h"
+#include "../../include/utils/CsvWriter.h"
+#include <cstring>
 
-Transaction::Transaction(const std::string& id, const std::string& accId, const std::string& transType, 
-                        double amt, const std::string& transDate)
-    : transactionId(id), accountId(accId), type(transType), amount(amt), date(transDate) {}
+Transaction::Transaction()
+    : transactionId(0), amountCents(0), timestamp(0), accountId(AccountId::INVALID), type(DEPOSIT) {}
 
-std::string Transaction::getTransactionId() const { 
-    return transactionId; 
+Transaction::Transaction(TransactionId id, AccountId accId, Type transType, Money amt, std::time_t time)
+    : transactionId(id.getValue()), amountCents(amt.getCents()),
+      timestamp(static_cast<int64_t>(time)), accountId(accId.getValue()), type(transType) {}
+
+TransactionId Transaction::getTransactionId() const { 
+    return TransactionId(transactionId); 
 }
 
-std::string Transaction::getAccountId() const { 
-    return accountId; 
+AccountId Transaction::getAccountId() const { 
+    return AccountId(accountId); 
 }
 
-std::string Transaction::getType() const { 
+Transaction::Type Transaction::getType() const { 
     return type; 
 }
 
-double Transaction::getAmount() const { 
-    return amount; 
+const char* Transaction::getTypeName() const {
+    return (type == DEPOSIT) ? "deposit" : "withdrawal";
+}
+
+Money Transaction::getAmount() const { 
+    return Money::fromCents(amountCents); 
+}
+
+std::time_t Transaction::getTimestamp() const {
+    return static_cast<std::time_t>(timestamp);
 }
 
 std::string Transaction::getDate() const { 
-    return date; 
+    return formatDate(getTimestamp()); 
 }
 
 std::string Transaction::toCSV() const {
-    return transactionId + "," + accountId + "," + type + "," + 
-            std::to_string(amount) + "," + date;
-}
\ No newline at end of file
+    char line[MAX_CSV_LENGTH];
+    return std::string(line, formatCSV(line));
+}
+
+void Transaction::writeCSV(CsvWriter& out) const {
+    out.advance(formatCSV(out.reserve(MAX_CSV_LENGTH)));
+}
+
+size_t Transaction::formatCSV(char* out) const {
+    size_t length = getTransactionId().format(out);
+    out[length++] = ',';
+
+    length += getAccountId().format(out + length);
+
+    const char* name = getTypeName();
+    out[length++] = ',';
+    size_t nameLength = std::strlen(name);
+    std::memcpy(out + length, name, nameLength);
+    length += nameLength;
+
+    out[length++] = ',';
+    length += getAmount().format(out + length);
+    out[length++] = ',';
+
+    length += formatDate(getTimestamp(), out + length);
+    return length;
+}
+
+bool Transaction::parseType(const char* text, size_t length, Type& type) {
+    if (length == 7 && std::memcmp(text, "deposit", 7) == 0) {
+        type = DEPOSIT;
+        return true;
+    }
+    if (length == 10 && std::memcmp(text, "withdrawal", 10) == 0) {
+        type = WITHDRAWAL;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,192 @@
+#include "../../include/System details/TransactionId.h"
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const uint64_t CUSTOM_EPOCH_MS = 1704067200000ull;   // 2024-01-01T00:00:00Z
+const unsigned SLOT_BITS = 10;
+const unsigned SEQUENCE_BITS = 12;
+const uint32_t SHARED_SLOT = (1u << SLOT_BITS) - 1; // Used under a lock once every other slot is taken
+const uint32_t MAX_SEQUENCE = (1u << SEQUENCE_BITS) - 1;
+
+const size_t GENERATED_DIGITS = 13;
+const char DIGITS[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+const uint64_t LEGACY_FLAG = 1ull << 63;
+const unsigned LEGACY_LENGTH_SHIFT = 57;
+const size_t LEGACY_MAX_CHARS = 11;                  // 36^11 < 2^57
+
+uint64_t nowMillis() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()) - CUSTOM_EPOCH_MS;
+}
+
+// Position in the ID space of one generator slot
+struct SlotState {
+    uint32_t slot;
+    uint64_t lastMillis;
+    uint32_t sequence;
+
+    uint64_t next() {
+        uint64_t now = nowMillis();
+        if (now > lastMillis) {
+            lastMillis = now;
+            sequence = 0;
+        } else if (++sequence > MAX_SEQUENCE) {
+            // Sequence exhausted within one millisecond (or the clock stepped back):
+            // borrow the next millisecond rather than wait for it
+            ++lastMillis;
+            sequence = 0;
+        }
+        return (lastMillis << (SLOT_BITS + SEQUENCE_BITS)) |
+               (static_cast<uint64_t>(slot) << SEQUENCE_BITS) | sequence;
+    }
+};
+
+/**
+ * Slots are handed to threads on first use and returned when they exit.
+ * A returned slot keeps its last timestamp and sequence, so the next owner
+ * continues after the IDs its previous owner already issued.
+ */
+class SlotPool {
+private:
+    std::mutex mutex;
+    std::vector<SlotState> released;
+    uint32_t nextFresh;
+    SlotState shared;
+
+public:
+    SlotPool() : nextFresh(0) {
+        shared.slot = SHARED_SLOT;
+        shared.lastMillis = 0;
+        shared.sequence = 0;
+    }
+
+    SlotState acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!released.empty()) {
+            SlotState state = released.back();
+            released.pop_back();
+            return state;
+        }
+        SlotState state;
+        state.slot = (nextFresh < SHARED_SLOT) ? nextFresh++ : SHARED_SLOT;
+        state.lastMillis = 0;
+        state.sequence = 0;
+        return state;
+    }
+
+    void release(const SlotState& state) {
+        if (state.slot == SHARED_SLOT) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        released.push_back(state);
+    }
+
+    uint64_t nextShared() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return shared.next();
+    }
+};
+
+SlotPool& slotPool() {
+    static SlotPool* pool = new SlotPool();   // Never destroyed: threads may exit during shutdown
+    return *pool;
+}
+
+struct ThreadGenerator {
+    SlotState state;
+
+    ThreadGenerator() : state(slotPool().acquire()) {}
+    ~ThreadGenerator() { slotPool().release(state); }
+
+    uint64_t next() {
+        return (state.slot == SHARED_SLOT) ? slotPool().nextShared() : state.next();
+    }
+};
+
+int digitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    for (int i = 10; i < 32; ++i) {
+        if (DIGITS[i] == c) return i;
+    }
+    return -1;
+}
+
+int base36Value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    return -1;
+}
+
+// Packs the random part of an old "TXN" + [0-9A-Z]{1,11} ID
+TransactionId parseLegacy(const char* chars, size_t count) {
+    if (count == 0 || count > LEGACY_MAX_CHARS) return TransactionId();
+    uint64_t number = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int digit = base36Value(chars[i]);
+        if (digit < 0) return TransactionId();
+        number = number * 36 + static_cast<uint64_t>(digit);
+    }
+    return TransactionId(LEGACY_FLAG | (static_cast<uint64_t>(count) << LEGACY_LENGTH_SHIFT) | number);
+}
+
+} // namespace
+
+TransactionId TransactionId::generate() {
+    static thread_local ThreadGenerator generator;
+    return TransactionId(generator.next());
+}
+
+TransactionId TransactionId::fromString(const std::string& text) {
+    return fromString(text.data(), text.size());
+}
+
+TransactionId TransactionId::fromString(const char* text, size_t length) {
+    if (length < 4 || text[0] != 'T' || text[1] != 'X' || text[2] != 'N') {
+        return TransactionId();
+    }
+    if (length != MAX_TEXT_LENGTH) {
+        return parseLegacy(text + 3, length - 3);
+    }
+
+    // The first digit holds only the top 3 bits (13 * 5 = 65 and the top bit is always clear)
+    uint64_t raw = 0;
+    for (size_t i = 3; i < MAX_TEXT_LENGTH; ++i) {
+        int digit = digitValue(text[i]);
+        if (digit < 0 || (i == 3 && digit > 7)) return TransactionId();
+        raw = (raw << 5) | static_cast<uint64_t>(digit);
+    }
+    return TransactionId(raw);
+}
+
+size_t TransactionId::format(char* out) const {
+    out[0] = 'T';
+    out[1] = 'X';
+    out[2] = 'N';
+
+    if (isLegacy()) {
+        size_t count = static_cast<size_t>((value >> LEGACY_LENGTH_SHIFT) & 0x3F);
+        uint64_t number = value & ((1ull << LEGACY_LENGTH_SHIFT) - 1);
+        for (size_t i = 3 + count; i > 3; --i) {
+            unsigned digit = static_cast<unsigned>(number % 36);
+            out[i - 1] = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+            number /= 36;
+        }
+        return 3 + count;
+    }
+
+    uint64_t raw = value;
+    for (size_t i = 3 + GENERATED_DIGITS; i > 3; --i) {
+        out[i - 1] = DIGITS[raw & 31];
+        raw >>= 5;
+    }
+    return MAX_TEXT_LENGTH;
+}
+
+std::string TransactionId::toString() const {
+    char buffer[MAX_TEXT_LENGTH];
+    size_t length = format(buffer);
+    return std::string(buffer, length);
+}
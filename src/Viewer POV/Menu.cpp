@@ -7,7 +7,8 @@ void displayMenu() {
     std::cout << "2. Login to Account\n";
     std::cout << "3. Display All Accounts\n";
     std::cout << "4. Test Password Strength\n";
-    std::cout << "5. Exit\n";
+    std::cout << "5. Operation Statistics\n";
+    std::cout << "6. Exit\n";
     std::cout << "==============================\n";
     std::cout << "Enter your choice: ";
 }
@@ -18,7 +19,8 @@ void displayAccountMenu(const std::string& accountId) {
     std::cout << "2. Deposit Money\n";
     std::cout << "3. Withdraw Money\n";
     std::cout << "4. Close Account\n";
-    std::cout << "5. Back to Main Menu\n";
+    std::cout << "5. View Statement\n";
+    std::cout << "6. Back to Main Menu\n";
     std::cout << "==============================\n";
     std::cout << "Enter your choice: ";
 }
\ No newline at end of file
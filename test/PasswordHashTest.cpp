@@ -0,0 +1,129 @@
+/**
+ * Known-answer tests for the password hashing primitives: SHA-256 against
+ * FIPS 180-2, PBKDF2-HMAC-SHA256 and scrypt against RFC 7914 (sections 11
+ * and 12), then the stored-hash round trip and the parameter limits.
+ * RFC 7914's last scrypt vector (N = 2^20, 1 GiB) is above
+ * PasswordHash::MAX_MEMORY and is checked as refused instead.
+ *
+ * Usage: password_hash_test      (exit status 2 if a check fails)
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../include/utils/PasswordHash.h"
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+std::string toHex(const uint8_t* data, size_t size) {
+    std::string text;
+    text.reserve(size * 2);
+    for (size_t i = 0; i < size; ++i) {
+        text += HEX_DIGITS[data[i] >> 4];
+        text += HEX_DIGITS[data[i] & 0x0f];
+    }
+    return text;
+}
+
+const uint8_t* bytes(const std::string& text) {
+    return reinterpret_cast<const uint8_t*>(text.data());
+}
+
+bool check(const std::string& what, bool ok) {
+    std::cout << (ok ? "ok     " : "FAILED ") << what << std::endl;
+    return ok;
+}
+
+bool checkHex(const std::string& what, const std::string& actual, const std::string& expected) {
+    if (actual == expected) return check(what, true);
+    check(what, false);
+    std::cout << "       expected " << expected << "\n       got      " << actual << std::endl;
+    return false;
+}
+
+bool sha256Vector(const std::string& what, const std::string& message, const std::string& expected) {
+    uint8_t digest[32];
+    PasswordHash::sha256(bytes(message), message.size(), digest);
+    return checkHex("SHA-256 " + what, toHex(digest, sizeof(digest)), expected);
+}
+
+bool pbkdf2Vector(const std::string& password, const std::string& salt, uint32_t iterations,
+                  const std::string& expected) {
+    uint8_t key[64];
+    PasswordHash::pbkdf2Sha256(bytes(password), password.size(), bytes(salt), salt.size(), iterations,
+                               key, sizeof(key));
+    return checkHex("PBKDF2-HMAC-SHA256 \"" + password + "\" c=" + std::to_string(iterations),
+                    toHex(key, sizeof(key)), expected);
+}
+
+bool scryptVector(const std::string& password, const std::string& salt, uint64_t n, uint32_t r, uint32_t p,
+                  const std::string& expected) {
+    uint8_t key[64];
+    PasswordHash::scrypt(bytes(password), password.size(), bytes(salt), salt.size(), n, r, p, key, sizeof(key));
+    return checkHex("scrypt \"" + password + "\" N=" + std::to_string(n) + " r=" + std::to_string(r) +
+                    " p=" + std::to_string(p), toHex(key, sizeof(key)), expected);
+}
+
+// A well-formed stored hash with the given parameters (the key itself doesn't matter)
+std::string storedHash(unsigned cost, unsigned r, unsigned p) {
+    return "$scrypt$" + std::to_string(cost) + "$" + std::to_string(r) + "$" + std::to_string(p) + "$" +
+           std::string(32, 'a') + "$" + std::string(64, 'b');
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+
+    // FIPS 180-2, appendix B
+    ok = sha256Vector("\"abc\"", "abc",
+                      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") && ok;
+    ok = sha256Vector("empty message", "",
+                      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855") && ok;
+    ok = sha256Vector("448-bit message", "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+                      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") && ok;
+    ok = sha256Vector("one million 'a'", std::string(1000000, 'a'),
+                      "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0") && ok;
+
+    // RFC 7914, section 11
+    ok = pbkdf2Vector("passwd", "salt", 1,
+                      "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+                      "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783") && ok;
+    ok = pbkdf2Vector("Password", "NaCl", 80000,
+                      "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"
+                      "a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d") && ok;
+
+    // RFC 7914, section 12
+    ok = scryptVector("", "", 16, 1, 1,
+                      "77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442"
+                      "fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c38d18906") && ok;
+    ok = scryptVector("password", "NaCl", 1024, 8, 16,
+                      "fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b373162"
+                      "2eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d8360cbdfa2cc0640") && ok;
+    ok = scryptVector("pleaseletmein", "SodiumChloride", 16384, 8, 1,
+                      "7023bdcb3afd7348461c06cd81fd38ebfda8fbba904f8e3ea9b543f6545da1f2"
+                      "d5432955613f0fcf62d49705242a9af9e61e85dc0d651e40dfcf017b45575887") && ok;
+
+    // Stored hashes
+    std::string stored = PasswordHash::hash("Abc#12345x", 10);
+    ok = check("hash verifies its password", PasswordHash::verify("Abc#12345x", stored)) && ok;
+    ok = check("hash rejects another password", !PasswordHash::verify("Abc#12345y", stored)) && ok;
+    ok = check("hash records its cost", PasswordHash::costOf(stored) == 10) && ok;
+    ok = check("plaintext credential still checks", PasswordHash::verify("plain", "plain") &&
+                                                    !PasswordHash::isHash("plain")) && ok;
+    ok = check("cost is clamped to MAX_COST",
+               PasswordHash::costOf(PasswordHash::hash("x", 40)) == PasswordHash::MAX_COST) && ok;
+
+    // Parameter limits: 128 * r * 2^cost bytes may not exceed MAX_MEMORY
+    ok = check("MAX_COST at the block factor fits MAX_MEMORY",
+               PasswordHash::isHash(storedHash(PasswordHash::MAX_COST, PasswordHash::BLOCK_FACTOR, 1))) && ok;
+    ok = check("r = 64 at MAX_COST (2 GiB) is refused",
+               !PasswordHash::isHash(storedHash(PasswordHash::MAX_COST, 64, 1))) && ok;
+    ok = check("RFC 7914's N = 2^20, r = 8 (1 GiB) is refused", !PasswordHash::isHash(storedHash(20, 8, 1))) && ok;
+    ok = check("a refused hash doesn't verify", !PasswordHash::verify("x", storedHash(20, 8, 1))) && ok;
+
+    return ok ? 0 : 2;
+}